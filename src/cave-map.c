@@ -92,13 +92,13 @@ void map_info(unsigned y, unsigned x, struct grid_data *g)
 	g->unseen_money = false;
 
 	/* Use real feature (remove later) */
-	g->f_idx = cave->squares[y][x].feat;
+	g->f_idx = cave->feat[y][x];
 	if (f_info[g->f_idx].mimic)
 		g->f_idx = lookup_feat(f_info[g->f_idx].mimic);
 
 	g->in_view = (square_isseen(cave, y, x)) ? true : false;
-	g->is_player = (cave->squares[y][x].mon < 0) ? true : false;
-	g->m_idx = (g->is_player) ? 0 : cave->squares[y][x].mon;
+	g->is_player = (cave->mon[y][x] < 0) ? true : false;
+	g->m_idx = (g->is_player) ? 0 : cave->mon[y][x];
 	g->hallucinate = player->timed[TMD_IMAGE] ? true : false;
 
 	if (g->in_view) {
@@ -116,13 +116,13 @@ void map_info(unsigned y, unsigned x, struct grid_data *g)
 	}
 
 	/* Use known feature */
-	g->f_idx = player->cave->squares[y][x].feat;
+	g->f_idx = player->cave->feat[y][x];
 	if (f_info[g->f_idx].mimic)
 		g->f_idx = lookup_feat(f_info[g->f_idx].mimic);
 
     /* There is a trap in this square */
     if (square_istrap(cave, y, x) && square_isknown(cave, y, x)) {
-		struct trap *trap = cave->squares[y][x].trap;
+		struct trap *trap = cave->trap[y][x];
 
 		/* Scan the square trap list */
 		while (trap) {
@@ -270,7 +270,7 @@ static void cave_light(struct point_set *ps)
 		int x = ps->pts[i].x;
 
 		/* Perma-Light */
-		sqinfo_on(cave->squares[y][x].info, SQUARE_GLOW);
+		sqinfo_on(cave->info[y][x], SQUARE_GLOW);
 	}
 
 	/* Fully update the visuals */
@@ -289,7 +289,7 @@ static void cave_light(struct point_set *ps)
 		square_light_spot(cave, y, x);
 
 		/* Process affected monsters */
-		if (cave->squares[y][x].mon > 0)
+		if (cave->mon[y][x] > 0)
 		{
 			int chance = 25;
 
@@ -329,7 +329,7 @@ static void cave_unlight(struct point_set *ps)
 		int x = ps->pts[i].x;
 
 		/* Darken the grid */
-		sqinfo_off(cave->squares[y][x].info, SQUARE_GLOW);
+		sqinfo_off(cave->info[y][x], SQUARE_GLOW);
 
 		/* Hack -- Forget "boring" grids */
 		if (square_isfloor(cave, y, x))
@@ -439,7 +439,7 @@ void wiz_light(struct chunk *c, bool full)
 					int xx = x + ddx_ddd[i];
 
 					/* Perma-light the grid */
-					sqinfo_on(c->squares[yy][xx].info, SQUARE_GLOW);
+					sqinfo_on(c->info[yy][xx], SQUARE_GLOW);
 
 					/* Memorize normal features */
 					if (!square_isfloor(c, yy, xx) || 
@@ -510,10 +510,10 @@ void cave_illuminate(struct chunk *c, bool daytime)
 
 			/* Only interesting grids at night */
 			if (daytime || !square_isfloor(c, y, x)) {
-				sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+				sqinfo_on(c->info[y][x], SQUARE_GLOW);
 				square_memorize(c, y, x);
 			} else {
-				sqinfo_off(c->squares[y][x].info, SQUARE_GLOW);
+				sqinfo_off(c->info[y][x], SQUARE_GLOW);
 				square_forget(c, y, x);
 			}
 		}
@@ -528,7 +528,7 @@ void cave_illuminate(struct chunk *c, bool daytime)
 			for (i = 0; i < 8; i++) {
 				int yy = y + ddy_ddd[i];
 				int xx = x + ddx_ddd[i];
-				sqinfo_on(c->squares[yy][xx].info, SQUARE_GLOW);
+				sqinfo_on(c->info[yy][xx], SQUARE_GLOW);
 				square_memorize(c, yy, xx);
 			}
 		}
@@ -567,8 +567,10 @@ void cave_known(struct player *p)
 			}
 
 			/* Internal walls not known */
-			if (count < 8)
-				p->cave->squares[y][x].feat = cave->squares[y][x].feat;
+			if (count < 8) {
+				p->cave->feat[y][x] = cave->feat[y][x];
+				update_projectable(p->cave, y, x);
+			}
 		}
 	}
 }
@@ -184,7 +184,7 @@ bool feat_is_smooth(int feat)
  * SQUARE FEATURE PREDICATES
  *
  * These functions are used to figure out what kind of square something is,
- * via c->squares[y][x].feat. All direct testing of c->squares[y][x].feat should be rewritten
+ * via c->feat[y][x]. All direct testing of c->feat[y][x] should be rewritten
  * in terms of these functions.
  *
  * It's often better to use square behavior predicates (written in terms of
@@ -200,7 +200,7 @@ bool feat_is_smooth(int feat)
  */
 bool square_isfloor(struct chunk *c, int y, int x)
 {
-	return feat_is_floor(c->squares[y][x].feat);
+	return feat_is_floor(c->feat[y][x]);
 }
 
 /**
@@ -208,7 +208,7 @@ bool square_isfloor(struct chunk *c, int y, int x)
  */
 bool square_istrappable(struct chunk *c, int y, int x)
 {
-	return feat_is_trap_holding(c->squares[y][x].feat);
+	return feat_is_trap_holding(c->feat[y][x]);
 }
 
 /**
@@ -216,7 +216,7 @@ bool square_istrappable(struct chunk *c, int y, int x)
  */
 bool square_isobjectholding(struct chunk *c, int y, int x)
 {
-	return feat_is_object_holding(c->squares[y][x].feat);
+	return feat_is_object_holding(c->feat[y][x]);
 }
 
 /**
@@ -224,8 +224,8 @@ bool square_isobjectholding(struct chunk *c, int y, int x)
  */
 bool square_isrock(struct chunk *c, int y, int x)
 {
-	return (tf_has(f_info[c->squares[y][x].feat].flags, TF_GRANITE) &&
-			!tf_has(f_info[c->squares[y][x].feat].flags, TF_DOOR_ANY));
+	return (tf_has(f_info[c->feat[y][x]].flags, TF_GRANITE) &&
+			!tf_has(f_info[c->feat[y][x]].flags, TF_DOOR_ANY));
 }
 
 /**
@@ -233,8 +233,8 @@ bool square_isrock(struct chunk *c, int y, int x)
  */
 bool square_isperm(struct chunk *c, int y, int x)
 {
-	return (tf_has(f_info[c->squares[y][x].feat].flags, TF_PERMANENT) &&
-			tf_has(f_info[c->squares[y][x].feat].flags, TF_ROCK));
+	return (tf_has(f_info[c->feat[y][x]].flags, TF_PERMANENT) &&
+			tf_has(f_info[c->feat[y][x]].flags, TF_ROCK));
 }
 
 /**
@@ -242,7 +242,7 @@ bool square_isperm(struct chunk *c, int y, int x)
  */
 bool square_ismagma(struct chunk *c, int y, int x)
 {
-	return feat_is_magma(c->squares[y][x].feat);
+	return feat_is_magma(c->feat[y][x]);
 }
 
 /**
@@ -250,7 +250,7 @@ bool square_ismagma(struct chunk *c, int y, int x)
  */
 bool square_isquartz(struct chunk *c, int y, int x)
 {
-	return feat_is_quartz(c->squares[y][x].feat);
+	return feat_is_quartz(c->feat[y][x]);
 }
 
 /**
@@ -258,7 +258,7 @@ bool square_isquartz(struct chunk *c, int y, int x)
  */
 bool square_isgranite(struct chunk *c, int y, int x)
 {
-	return feat_is_granite(c->squares[y][x].feat);
+	return feat_is_granite(c->feat[y][x]);
 }
 
 /**
@@ -272,7 +272,7 @@ bool square_ismineral(struct chunk *c, int y, int x)
 
 bool square_hasgoldvein(struct chunk *c, int y, int x)
 {
-	return tf_has(f_info[c->squares[y][x].feat].flags, TF_GOLD);
+	return tf_has(f_info[c->feat[y][x]].flags, TF_GOLD);
 }
 
 /**
@@ -280,8 +280,8 @@ bool square_hasgoldvein(struct chunk *c, int y, int x)
  */
 bool square_isrubble(struct chunk *c, int y, int x)
 {
-    return (!tf_has(f_info[c->squares[y][x].feat].flags, TF_WALL) &&
-			tf_has(f_info[c->squares[y][x].feat].flags, TF_ROCK));
+    return (!tf_has(f_info[c->feat[y][x]].flags, TF_WALL) &&
+			tf_has(f_info[c->feat[y][x]].flags, TF_ROCK));
 }
 
 /**
@@ -292,8 +292,8 @@ bool square_isrubble(struct chunk *c, int y, int x)
  */
 bool square_issecretdoor(struct chunk *c, int y, int x)
 {
-    return (tf_has(f_info[c->squares[y][x].feat].flags, TF_DOOR_ANY) &&
-			tf_has(f_info[c->squares[y][x].feat].flags, TF_ROCK));
+    return (tf_has(f_info[c->feat[y][x]].flags, TF_DOOR_ANY) &&
+			tf_has(f_info[c->feat[y][x]].flags, TF_ROCK));
 }
 
 /**
@@ -301,7 +301,7 @@ bool square_issecretdoor(struct chunk *c, int y, int x)
  */
 bool square_isopendoor(struct chunk *c, int y, int x)
 {
-    return (tf_has(f_info[c->squares[y][x].feat].flags, TF_CLOSABLE));
+    return (tf_has(f_info[c->feat[y][x]].flags, TF_CLOSABLE));
 }
 
 /**
@@ -309,13 +309,13 @@ bool square_isopendoor(struct chunk *c, int y, int x)
  */
 bool square_iscloseddoor(struct chunk *c, int y, int x)
 {
-	int feat = c->squares[y][x].feat;
+	int feat = c->feat[y][x];
 	return tf_has(f_info[feat].flags, TF_DOOR_CLOSED);
 }
 
 bool square_isbrokendoor(struct chunk *c, int y, int x)
 {
-	int feat = c->squares[y][x].feat;
+	int feat = c->feat[y][x];
     return (tf_has(f_info[feat].flags, TF_DOOR_ANY) &&
 			tf_has(f_info[feat].flags, TF_PASSABLE) &&
 			!tf_has(f_info[feat].flags, TF_CLOSABLE));
@@ -328,7 +328,7 @@ bool square_isbrokendoor(struct chunk *c, int y, int x)
  */
 bool square_isdoor(struct chunk *c, int y, int x)
 {
-	int feat = c->squares[y][x].feat;
+	int feat = c->feat[y][x];
 	return tf_has(f_info[feat].flags, TF_DOOR_ANY);
 }
 
@@ -337,7 +337,7 @@ bool square_isdoor(struct chunk *c, int y, int x)
  */
 bool square_isstairs(struct chunk *c, int y, int x)
 {
-	int feat = c->squares[y][x].feat;
+	int feat = c->feat[y][x];
 	return tf_has(f_info[feat].flags, TF_STAIR);
 }
 
@@ -346,7 +346,7 @@ bool square_isstairs(struct chunk *c, int y, int x)
  */
 bool square_isupstairs(struct chunk*c, int y, int x)
 {
-	int feat = c->squares[y][x].feat;
+	int feat = c->feat[y][x];
 	return tf_has(f_info[feat].flags, TF_UPSTAIR);
 }
 
@@ -355,7 +355,7 @@ bool square_isupstairs(struct chunk*c, int y, int x)
  */
 bool square_isdownstairs(struct chunk *c, int y, int x)
 {
-	int feat = c->squares[y][x].feat;
+	int feat = c->feat[y][x];
 	return tf_has(f_info[feat].flags, TF_DOWNSTAIR);
 }
 
@@ -364,14 +364,14 @@ bool square_isdownstairs(struct chunk *c, int y, int x)
  */
 bool square_isshop(struct chunk *c, int y, int x)
 {
-	return feat_is_shop(c->squares[y][x].feat);
+	return feat_is_shop(c->feat[y][x]);
 }
 
 /**
  * True if the square contains the player
  */
 bool square_isplayer(struct chunk *c, int y, int x) {
-	return c->squares[y][x].mon < 0 ? true : false;
+	return c->mon[y][x] < 0 ? true : false;
 }
 
 /**
@@ -380,7 +380,7 @@ bool square_isplayer(struct chunk *c, int y, int x) {
 bool square_isknown(struct chunk *c, int y, int x) {
 	if (c != cave) return false;
 	if (player->cave == NULL) return false;
-	return player->cave->squares[y][x].feat == FEAT_NONE ? false : true;
+	return player->cave->feat[y][x] == FEAT_NONE ? false : true;
 }
 
 /**
@@ -390,7 +390,7 @@ bool square_isknown(struct chunk *c, int y, int x) {
 bool square_isnotknown(struct chunk *c, int y, int x) {
 	if (c != cave) return false;
 	if (player->cave == NULL) return true;
-	return (player->cave->squares[y][x].feat != c->squares[y][x].feat);
+	return (player->cave->feat[y][x] != c->feat[y][x]);
 }
 
 /**
@@ -406,7 +406,7 @@ bool square_isnotknown(struct chunk *c, int y, int x) {
  */
 bool square_ismark(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_MARK);
+	return sqinfo_has(c->info[y][x], SQUARE_MARK);
 }
 
 /**
@@ -414,7 +414,7 @@ bool square_ismark(struct chunk *c, int y, int x) {
  */
 bool square_isglow(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_GLOW);
+	return sqinfo_has(c->info[y][x], SQUARE_GLOW);
 }
 
 /**
@@ -424,7 +424,7 @@ bool square_isglow(struct chunk *c, int y, int x) {
  */
 bool square_isvault(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_VAULT);
+	return sqinfo_has(c->info[y][x], SQUARE_VAULT);
 }
 
 /**
@@ -432,7 +432,7 @@ bool square_isvault(struct chunk *c, int y, int x) {
  */
 bool square_isroom(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_ROOM);
+	return sqinfo_has(c->info[y][x], SQUARE_ROOM);
 }
 
 /**
@@ -440,7 +440,7 @@ bool square_isroom(struct chunk *c, int y, int x) {
  */
 bool square_isseen(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_SEEN);
+	return sqinfo_has(c->info[y][x], SQUARE_SEEN);
 }
 
 /**
@@ -448,7 +448,7 @@ bool square_isseen(struct chunk *c, int y, int x) {
  */
 bool square_isview(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_VIEW);
+	return sqinfo_has(c->info[y][x], SQUARE_VIEW);
 }
 
 /**
@@ -456,7 +456,7 @@ bool square_isview(struct chunk *c, int y, int x) {
  */
 bool square_wasseen(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_WASSEEN);
+	return sqinfo_has(c->info[y][x], SQUARE_WASSEEN);
 }
 
 /**
@@ -464,7 +464,7 @@ bool square_wasseen(struct chunk *c, int y, int x) {
  */
 bool square_isfeel(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_FEEL);
+	return sqinfo_has(c->info[y][x], SQUARE_FEEL);
 }
 
 /**
@@ -472,7 +472,7 @@ bool square_isfeel(struct chunk *c, int y, int x) {
  */
 bool square_istrap(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_TRAP);
+	return sqinfo_has(c->info[y][x], SQUARE_TRAP);
 }
 
 /**
@@ -480,7 +480,7 @@ bool square_istrap(struct chunk *c, int y, int x) {
  */
 bool square_isinvis(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_INVIS);
+	return sqinfo_has(c->info[y][x], SQUARE_INVIS);
 }
 
 /**
@@ -488,7 +488,7 @@ bool square_isinvis(struct chunk *c, int y, int x) {
  */
 bool square_iswall_inner(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_WALL_INNER);
+	return sqinfo_has(c->info[y][x], SQUARE_WALL_INNER);
 }
 
 /**
@@ -496,7 +496,7 @@ bool square_iswall_inner(struct chunk *c, int y, int x) {
  */
 bool square_iswall_outer(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_WALL_OUTER);
+	return sqinfo_has(c->info[y][x], SQUARE_WALL_OUTER);
 }
 
 /**
@@ -504,7 +504,7 @@ bool square_iswall_outer(struct chunk *c, int y, int x) {
  */
 bool square_iswall_solid(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_WALL_SOLID);
+	return sqinfo_has(c->info[y][x], SQUARE_WALL_SOLID);
 }
 
 /**
@@ -512,7 +512,7 @@ bool square_iswall_solid(struct chunk *c, int y, int x) {
  */
 bool square_ismon_restrict(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_MON_RESTRICT);
+	return sqinfo_has(c->info[y][x], SQUARE_MON_RESTRICT);
 }
 
 /**
@@ -520,7 +520,7 @@ bool square_ismon_restrict(struct chunk *c, int y, int x) {
  */
 bool square_isno_teleport(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_NO_TELEPORT);
+	return sqinfo_has(c->info[y][x], SQUARE_NO_TELEPORT);
 }
 
 /**
@@ -528,7 +528,7 @@ bool square_isno_teleport(struct chunk *c, int y, int x) {
  */
 bool square_isno_map(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_NO_MAP);
+	return sqinfo_has(c->info[y][x], SQUARE_NO_MAP);
 }
 
 /**
@@ -536,7 +536,7 @@ bool square_isno_map(struct chunk *c, int y, int x) {
  */
 bool square_isno_esp(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_NO_ESP);
+	return sqinfo_has(c->info[y][x], SQUARE_NO_ESP);
 }
 
 /**
@@ -544,7 +544,7 @@ bool square_isno_esp(struct chunk *c, int y, int x) {
  */
 bool square_isproject(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_PROJECT);
+	return sqinfo_has(c->info[y][x], SQUARE_PROJECT);
 }
 
 /**
@@ -552,7 +552,7 @@ bool square_isproject(struct chunk *c, int y, int x) {
  */
 bool square_isdtrap(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return sqinfo_has(c->squares[y][x].info, SQUARE_DTRAP);
+	return sqinfo_has(c->info[y][x], SQUARE_DTRAP);
 }
 
 
@@ -570,7 +570,7 @@ bool square_isdtrap(struct chunk *c, int y, int x) {
  * True if the square is open (a floor square not occupied by a monster).
  */
 bool square_isopen(struct chunk *c, int y, int x) {
-	return square_isfloor(c, y, x) && !c->squares[y][x].mon;
+	return square_isfloor(c, y, x) && !c->mon[y][x];
 }
 
 /**
@@ -610,7 +610,7 @@ bool square_isdiggable(struct chunk *c, int y, int x) {
 bool square_is_monster_walkable(struct chunk *c, int y, int x)
 {
 	assert(square_in_bounds(c, y, x));
-	return feat_is_monster_walkable(c->squares[y][x].feat);
+	return feat_is_monster_walkable(c->feat[y][x]);
 }
 
 /**
@@ -618,7 +618,7 @@ bool square_is_monster_walkable(struct chunk *c, int y, int x)
  */
 bool square_ispassable(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return feat_is_passable(c->squares[y][x].feat);
+	return feat_is_passable(c->feat[y][x]);
 }
 
 /**
@@ -628,7 +628,7 @@ bool square_ispassable(struct chunk *c, int y, int x) {
  */
 bool square_isprojectable(struct chunk *c, int y, int x) {
 	if (!square_in_bounds(c, y, x)) return false;
-	return feat_is_projectable(c->squares[y][x].feat);
+	return feat_is_projectable(c->feat[y][x]);
 }
 
 /**
@@ -657,7 +657,7 @@ bool square_isstrongwall(struct chunk *c, int y, int x) {
  */
 bool square_isbright(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return feat_is_bright(c->squares[y][x].feat);
+	return feat_is_bright(c->feat[y][x]);
 }
 
 /**
@@ -665,7 +665,7 @@ bool square_isbright(struct chunk *c, int y, int x) {
  */
 bool square_isfiery(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return feat_is_fiery(c->squares[y][x].feat);
+	return feat_is_fiery(c->feat[y][x]);
 }
 
 /**
@@ -673,7 +673,7 @@ bool square_isfiery(struct chunk *c, int y, int x) {
  */
 bool square_isdamaging(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return feat_is_fiery(c->squares[y][x].feat);
+	return feat_is_fiery(c->feat[y][x]);
 }
 
 /**
@@ -681,7 +681,7 @@ bool square_isdamaging(struct chunk *c, int y, int x) {
  */
 bool square_isnoflow(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return feat_is_no_flow(c->squares[y][x].feat);
+	return feat_is_no_flow(c->feat[y][x]);
 }
 
 /**
@@ -689,7 +689,7 @@ bool square_isnoflow(struct chunk *c, int y, int x) {
  */
 bool square_isnoscent(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
-	return feat_is_no_scent(c->squares[y][x].feat);
+	return feat_is_no_scent(c->feat[y][x]);
 }
 
 bool square_iswarded(struct chunk *c, int y, int x)
@@ -705,12 +705,12 @@ bool square_canward(struct chunk *c, int y, int x)
 
 bool square_seemslikewall(struct chunk *c, int y, int x)
 {
-	return tf_has(f_info[c->squares[y][x].feat].flags, TF_ROCK);
+	return tf_has(f_info[c->feat[y][x]].flags, TF_ROCK);
 }
 
 bool square_isinteresting(struct chunk *c, int y, int x)
 {
-	int f = c->squares[y][x].feat;
+	int f = c->feat[y][x];
 	return tf_has(f_info[f].flags, TF_INTERESTING);
 }
 
@@ -831,7 +831,7 @@ bool square_in_bounds_fully(struct chunk *c, int y, int x)
 struct feature *square_feat(struct chunk *c, int y, int x)
 {
 	assert(square_in_bounds(c, y, x));
-	return &f_info[c->squares[y][x].feat];
+	return &f_info[c->feat[y][x]];
 }
 
 /**
@@ -840,8 +840,8 @@ struct feature *square_feat(struct chunk *c, int y, int x)
 struct monster *square_monster(struct chunk *c, int y, int x)
 {
 	if (!square_in_bounds(c, y, x)) return NULL;
-	if (c->squares[y][x].mon > 0) {
-		struct monster *mon = cave_monster(c, c->squares[y][x].mon);
+	if (c->mon[y][x] > 0) {
+		struct monster *mon = cave_monster(c, c->mon[y][x]);
 		return mon->race ? mon : NULL;
 	}
 
@@ -853,7 +853,7 @@ struct monster *square_monster(struct chunk *c, int y, int x)
  */
 struct object *square_object(struct chunk *c, int y, int x) {
 	if (!square_in_bounds(c, y, x)) return NULL;
-	return c->squares[y][x].obj;
+	return c->obj[y][x];
 }
 
 /**
@@ -862,7 +862,7 @@ struct object *square_object(struct chunk *c, int y, int x) {
 struct trap *square_trap(struct chunk *c, int y, int x)
 {
 	if (!square_in_bounds(c, y, x)) return NULL;
-    return c->squares[y][x].trap;
+    return c->trap[y][x];
 }
 
 /**
@@ -878,7 +878,7 @@ bool square_holds_object(struct chunk *c, int y, int x, struct object *obj) {
  */
 void square_excise_object(struct chunk *c, int y, int x, struct object *obj) {
 	assert(square_in_bounds(c, y, x));
-	pile_excise(&c->squares[y][x].obj, obj);
+	pile_excise(&c->obj[y][x], obj);
 }
 
 /**
@@ -887,7 +887,7 @@ void square_excise_object(struct chunk *c, int y, int x, struct object *obj) {
 void square_excise_pile(struct chunk *c, int y, int x) {
 	assert(square_in_bounds(c, y, x));
 	object_pile_free(square_object(c, y, x));
-	c->squares[y][x].obj = NULL;
+	c->obj[y][x] = NULL;
 }
 
 /**
@@ -960,14 +960,19 @@ void square_set_feat(struct chunk *c, int y, int x, int feat)
 	int current_feat;
 
 	assert(square_in_bounds(c, y, x));
-	current_feat = c->squares[y][x].feat;
+	current_feat = c->feat[y][x];
 
 	/* Track changes */
 	if (current_feat) c->feat_count[current_feat]--;
 	if (feat) c->feat_count[feat]++;
 
+	/* Noise spreading through the old terrain has to stop doing so */
+	if (feat_is_no_flow(current_feat) != feat_is_no_flow(feat))
+		cave_noise_settle(c);
+
 	/* Make the change */
-	c->squares[y][x].feat = feat;
+	c->feat[y][x] = feat;
+	update_projectable(c, y, x);
 
 	/* Make the new terrain feel at home */
 	if (character_dungeon) {
@@ -979,9 +984,9 @@ void square_set_feat(struct chunk *c, int y, int x, int feat)
 		square_light_spot(c, y, x);
 	} else {
 		/* Make sure no incorrect wall flags set for dungeon generation */
-		sqinfo_off(c->squares[y][x].info, SQUARE_WALL_INNER);
-		sqinfo_off(c->squares[y][x].info, SQUARE_WALL_OUTER);
-		sqinfo_off(c->squares[y][x].info, SQUARE_WALL_SOLID);
+		sqinfo_off(c->info[y][x], SQUARE_WALL_INNER);
+		sqinfo_off(c->info[y][x], SQUARE_WALL_OUTER);
+		sqinfo_off(c->info[y][x], SQUARE_WALL_SOLID);
 	}
 }
 
@@ -1105,9 +1110,9 @@ void square_remove_ward(struct chunk *c, int y, int x)
  */
 void square_upgrade_mineral(struct chunk *c, int y, int x)
 {
-	if (c->squares[y][x].feat == FEAT_MAGMA)
+	if (c->feat[y][x] == FEAT_MAGMA)
 		square_set_feat(c, y, x, FEAT_MAGMA_K);
-	if (c->squares[y][x].feat == FEAT_QUARTZ)
+	if (c->feat[y][x] == FEAT_QUARTZ)
 		square_set_feat(c, y, x, FEAT_QUARTZ_K);
 }
 
@@ -1123,18 +1128,18 @@ void square_force_floor(struct chunk *c, int y, int x) {
 /* Note that this returns the STORE_ index, which is one less than shopnum */
 int square_shopnum(struct chunk *c, int y, int x) {
 	if (square_isshop(c, y, x))
-		return f_info[c->squares[y][x].feat].shopnum - 1;
+		return f_info[c->feat[y][x]].shopnum - 1;
 	return -1;
 }
 
 int square_digging(struct chunk *c, int y, int x) {
 	if (square_isdiggable(c, y, x))
-		return f_info[c->squares[y][x].feat].dig;
+		return f_info[c->feat[y][x]].dig;
 	return 0;
 }
 
 const char *square_apparent_name(struct chunk *c, struct player *p, int y, int x) {
-	int actual = player->cave->squares[y][x].feat;
+	int actual = player->cave->feat[y][x];
 	char *mimic_name = f_info[actual].mimic;
 	int f = mimic_name ? lookup_feat(mimic_name) : actual;
 	return f_info[f].name;
@@ -1142,18 +1147,20 @@ const char *square_apparent_name(struct chunk *c, struct player *p, int y, int x
 
 void square_memorize(struct chunk *c, int y, int x) {
 	if (c != cave) return;
-	player->cave->squares[y][x].feat = c->squares[y][x].feat;
+	player->cave->feat[y][x] = c->feat[y][x];
+	update_projectable(player->cave, y, x);
 }
 
 void square_forget(struct chunk *c, int y, int x) {
 	if (c != cave) return;
-	player->cave->squares[y][x].feat = FEAT_NONE;
+	player->cave->feat[y][x] = FEAT_NONE;
+	update_projectable(player->cave, y, x);
 }
 
 void square_mark(struct chunk *c, int y, int x) {
-	sqinfo_on(c->squares[y][x].info, SQUARE_MARK);
+	sqinfo_on(c->info[y][x], SQUARE_MARK);
 }
 
 void square_unmark(struct chunk *c, int y, int x) {
-	sqinfo_off(c->squares[y][x].info, SQUARE_MARK);
+	sqinfo_off(c->info[y][x], SQUARE_MARK);
 }
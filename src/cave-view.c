@@ -44,6 +44,84 @@ int distance(int y1, int x1, int y2, int x2)
 }
 
 
+/**
+ * A precomputed line of sight ray from a grid to one at a given offset.
+ *
+ * The grids los_walk() visits between two points depend only on their
+ * offset, so for each offset within los_radius we record them as one mask
+ * per row, with bit (dx + los_radius) standing for column offset dx.  A grid
+ * then has line of sight if every masked grid is set in the chunk's
+ * projectable bitplane, or for a knight's move if the knight grid is.
+ */
+struct los_ray {
+	int row;			/* Row offset of the first mask */
+	int n_rows;			/* Number of masks */
+	u64b *masks;		/* Column masks, one per row */
+	bool knight;		/* Whether the knight's move rule applies */
+	int knight_y;		/* Offset of the grid giving a knight's move LOS */
+	int knight_x;
+};
+
+static struct los_ray *los_rays;
+static u64b *los_ray_masks;
+static int los_radius;
+
+/**
+ * Check whether a grid is set in a chunk's projectable bitplane
+ */
+static bool los_projectable(struct chunk *c, int y, int x)
+{
+	int col = x + PROJECTABLE_PAD;
+	return (c->projectable[y * c->projectable_words + col / 64] >>
+			(col % 64)) & 1;
+}
+
+/**
+ * Keep the projectable bitplane in step with the terrain of a grid.  This
+ * must be called whenever a grid's feature changes.
+ */
+void update_projectable(struct chunk *c, int y, int x)
+{
+	int col = x + PROJECTABLE_PAD;
+	u64b *word = &c->projectable[y * c->projectable_words + col / 64];
+	u64b bit = (u64b)1 << (col % 64);
+
+	if (feat_is_projectable(c->feat[y][x]))
+		*word |= bit;
+	else
+		*word &= ~bit;
+}
+
+/**
+ * Test a grid on a line of sight, or add it to the ray being built
+ */
+static bool los_check(struct chunk *c, struct los_ray *ray, int y, int x)
+{
+	if (!ray)
+		return square_isprojectable(c, y, x);
+
+	ray->masks[y - ray->row] |= (u64b)1 << (x + los_radius);
+
+	/* Keep going */
+	return true;
+}
+
+/**
+ * Test the knight's move grid, or note it in the ray being built
+ */
+static bool los_knight(struct chunk *c, struct los_ray *ray, int y, int x)
+{
+	if (!ray)
+		return square_isprojectable(c, y, x);
+
+	ray->knight = true;
+	ray->knight_y = y;
+	ray->knight_x = x;
+
+	/* Record the rest of the ray as well */
+	return false;
+}
+
 /**
  * A simple, fast, integer-based line-of-sight algorithm.  By Joseph Hall,
  * 4116 Brewster Drive, Raleigh NC 27606.  Email to jnh@ecemwl.ncsu.edu.
@@ -79,8 +157,12 @@ int distance(int y1, int x1, int y2, int x2)
  * are "viewable" by the player, which is used for many things, such as
  * determining which grids are illuminated by the player's torch, and which
  * grids and monsters can be "seen" by the player, etc).
+ *
+ * If `ray` is given, no chunk is examined; instead the grids that would be
+ * tested are recorded in the ray.
  */
-bool los(struct chunk *c, int y1, int x1, int y2, int x2)
+static bool los_walk(struct chunk *c, struct los_ray *ray, int y1, int x1,
+					 int y2, int x2)
 {
 	/* Delta */
 	int dx, dy;
@@ -122,10 +204,10 @@ bool los(struct chunk *c, int y1, int x1, int y2, int x2)
 		/* South -- check for walls */
 		if (dy > 0) {
 			for (ty = y1 + 1; ty < y2; ty++)
-				if (!square_isprojectable(c, ty, x1)) return (false);
+				if (!los_check(c, ray, ty, x1)) return (false);
 		} else { /* North -- check for walls */
 			for (ty = y1 - 1; ty > y2; ty--)
-				if (!square_isprojectable(c, ty, x1)) return (false);
+				if (!los_check(c, ray, ty, x1)) return (false);
 		}
 
 		/* Assume los */
@@ -137,10 +219,10 @@ bool los(struct chunk *c, int y1, int x1, int y2, int x2)
 		/* East -- check for walls */
 		if (dx > 0) {
 			for (tx = x1 + 1; tx < x2; tx++)
-				if (!square_isprojectable(c, y1, tx)) return (false);
+				if (!los_check(c, ray, y1, tx)) return (false);
 		} else { /* West -- check for walls */
 			for (tx = x1 - 1; tx > x2; tx--)
-				if (!square_isprojectable(c, y1, tx)) return (false);
+				if (!los_check(c, ray, y1, tx)) return (false);
 		}
 
 		/* Assume los */
@@ -153,11 +235,11 @@ bool los(struct chunk *c, int y1, int x1, int y2, int x2)
 	sy = (dy < 0) ? -1 : 1;
 
 	/* Vertical "knights" */
-	if ((ax == 1) && (ay == 2) && square_isprojectable(c, y1 + sy, x1))
+	if ((ax == 1) && (ay == 2) && los_knight(c, ray, y1 + sy, x1))
 		return (true);
 	
 	/* Horizontal "knights" */
-	else if ((ay == 1) && (ax == 2) && square_isprojectable(c, y1, x1 + sx))
+	else if ((ay == 1) && (ax == 2) && los_knight(c, ray, y1, x1 + sx))
 		return (true);
 
 	/* Calculate scale factor div 2 */
@@ -186,7 +268,7 @@ bool los(struct chunk *c, int y1, int x1, int y2, int x2)
 		/* Note (below) the case (qy == f2), where */
 		/* the LOS exactly meets the corner of a tile. */
 		while (x2 - tx) {
-			if (!square_isprojectable(c, ty, tx))
+			if (!los_check(c, ray, ty, tx))
 				return (false);
 
 			qy += m;
@@ -195,7 +277,7 @@ bool los(struct chunk *c, int y1, int x1, int y2, int x2)
 				tx += sx;
 			} else if (qy > f2) {
 				ty += sy;
-				if (!square_isprojectable(c, ty, tx))
+				if (!los_check(c, ray, ty, tx))
 					return (false);
 				qy -= f1;
 				tx += sx;
@@ -222,7 +304,7 @@ bool los(struct chunk *c, int y1, int x1, int y2, int x2)
 		/* Note (below) the case (qx == f2), where */
 		/* the LOS exactly meets the corner of a tile. */
 		while (y2 - ty) {
-			if (!square_isprojectable(c, ty, tx))
+			if (!los_check(c, ray, ty, tx))
 				return (false);
 
 			qx += m;
@@ -231,7 +313,7 @@ bool los(struct chunk *c, int y1, int x1, int y2, int x2)
 				ty += sy;
 			} else if (qx > f2) {
 				tx += sx;
-				if (!square_isprojectable(c, ty, tx))
+				if (!los_check(c, ray, ty, tx))
 					return (false);
 				qx -= f1;
 				ty += sy;
@@ -247,6 +329,108 @@ bool los(struct chunk *c, int y1, int x1, int y2, int x2)
 	return (true);
 }
 
+/**
+ * Determine whether there is a line of sight between two grids.
+ *
+ * This gives exactly the same answers as los_walk(), but for the offsets
+ * most used it just compares the precomputed ray with the chunk's
+ * projectable bitplane, a word per row.
+ */
+bool los(struct chunk *c, int y1, int x1, int y2, int x2)
+{
+	int dy = y2 - y1;
+	int dx = x2 - x1;
+	int start, i;
+	struct los_ray *ray;
+
+	/* Handle adjacent (or identical) grids */
+	if ((ABS(dx) < 2) && (ABS(dy) < 2)) return (true);
+
+	/* Trace long lines, or lines in chunks without a bitplane */
+	if (!los_rays || !c->projectable || (ABS(dy) > los_radius) ||
+		(ABS(dx) > los_radius))
+		return los_walk(c, NULL, y1, x1, y2, x2);
+
+	ray = &los_rays[(dy + los_radius) * (2 * los_radius + 1) + dx + los_radius];
+
+	/* Knight's moves may see past one corner */
+	if (ray->knight &&
+		los_projectable(c, y1 + ray->knight_y, x1 + ray->knight_x))
+		return (true);
+
+	/* Read the bits of each row under the ray's masks */
+	start = x1 - los_radius + PROJECTABLE_PAD;
+	for (i = 0; i < ray->n_rows; i++) {
+		const u64b *row = c->projectable +
+			(y1 + ray->row + i) * c->projectable_words;
+		u64b bits = row[start / 64] >> (start % 64);
+		if (start % 64)
+			bits |= row[start / 64 + 1] << (64 - start % 64);
+
+		if ((bits & ray->masks[i]) != ray->masks[i])
+			return (false);
+	}
+
+	return (true);
+}
+
+/**
+ * Precompute the line of sight rays for all offsets up to max_sight
+ */
+static void los_init(void)
+{
+	int dy, dx, side;
+	u64b *masks;
+
+	/* Column masks have to fit in one word */
+	los_radius = MIN(z_info->max_sight, 31);
+	side = 2 * los_radius + 1;
+
+	los_rays = mem_zalloc(side * side * sizeof(struct los_ray));
+	los_ray_masks = mem_zalloc(side * side * side * sizeof(u64b));
+
+	masks = los_ray_masks;
+	for (dy = -los_radius; dy <= los_radius; dy++) {
+		for (dx = -los_radius; dx <= los_radius; dx++) {
+			struct los_ray *ray = &los_rays[(dy + los_radius) * side +
+											dx + los_radius];
+			ray->masks = masks;
+			masks += side;
+
+			/* Adjacent grids are handled directly */
+			if ((ABS(dx) < 2) && (ABS(dy) < 2)) continue;
+
+			/* Record the ray over all the rows it could cross */
+			ray->row = MIN(dy, 0);
+			ray->n_rows = ABS(dy) + 1;
+			los_walk(NULL, ray, 0, 0, dy, dx);
+
+			/* Trim rows with nothing to test */
+			while (ray->n_rows && !ray->masks[0]) {
+				ray->masks++;
+				ray->row++;
+				ray->n_rows--;
+			}
+			while (ray->n_rows && !ray->masks[ray->n_rows - 1])
+				ray->n_rows--;
+		}
+	}
+}
+
+static void los_cleanup(void)
+{
+	mem_free(los_rays);
+	mem_free(los_ray_masks);
+	los_rays = NULL;
+	los_ray_masks = NULL;
+}
+
+struct init_module view_module = {
+	.name = "view",
+	.init = los_init,
+	.cleanup = los_cleanup
+};
+
 /**
  * The comments below are still predominantly true, and have been left
  * (slightly modified for accuracy) for historical and nostalgic reasons.
@@ -288,8 +472,8 @@ bool los(struct chunk *c, int y1, int x1, int y2, int x2)
  * twice is inconsequential compared to the speed increase.
  *
  * Several pieces of information about each cave grid are stored in the
- * info field of the "cave->squares" array, which is a special array of
- * bitflags.
+ * "cave->info" array, which holds a special array of bitflags for each
+ * grid.
  *
  * The "SQUARE_ROOM" flag is used to determine which grids are part of "rooms", 
  * and thus which grids are affected by "illumination" spells.
@@ -428,21 +612,58 @@ bool los(struct chunk *c, int y1, int x1, int y2, int x2)
 
 
 /**
- * Mark the currently seen grids, then wipe in preparation for recalculating
+ * Mark the currently seen grids, then wipe in preparation for recalculating.
+ *
+ * Only the grids in the chunk's view list can have been part of the last
+ * view; if there is no list (for a chunk that has just been created, copied
+ * or loaded) the whole chunk is checked and the list is set up.
  */
 static void mark_wasseen(struct chunk *c)
 {
-	int x, y;
-	/* Save the old "view" grids for later */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			if (square_isseen(c, y, x))
-				sqinfo_on(c->squares[y][x].info, SQUARE_WASSEEN);
-			sqinfo_off(c->squares[y][x].info, SQUARE_VIEW);
-			sqinfo_off(c->squares[y][x].info, SQUARE_SEEN);
+	int x, y, i;
+
+	if (!c->view_grids) {
+		int side = 2 * z_info->max_sight + 1;
+
+		/* The old view and the new one each fit in the view window */
+		c->view_grids = mem_zalloc(2 * side * side * sizeof(struct loc));
+		c->view_grids_n = 0;
+
+		/* Save the old "view" grids for later */
+		for (y = 0; y < c->height; y++) {
+			for (x = 0; x < c->width; x++) {
+				if (square_isseen(c, y, x))
+					sqinfo_on(c->info[y][x], SQUARE_WASSEEN);
+				sqinfo_off(c->info[y][x], SQUARE_VIEW);
+				sqinfo_off(c->info[y][x], SQUARE_SEEN);
+			}
 		}
+		return;
+	}
+
+	/* Save the old "view" grids for later */
+	for (i = 0; i < c->view_grids_n; i++) {
+		y = c->view_grids[i].y;
+		x = c->view_grids[i].x;
+		if (square_isseen(c, y, x))
+			sqinfo_on(c->info[y][x], SQUARE_WASSEEN);
+		sqinfo_off(c->info[y][x], SQUARE_VIEW);
+		sqinfo_off(c->info[y][x], SQUARE_SEEN);
 	}
 }
+
+/**
+ * Mark a square as part of the view, and remember it in the view list
+ */
+static void mark_view(struct chunk *c, int y, int x)
+{
+	if (square_isview(c, y, x))
+		return;
+
+	sqinfo_on(c->info[y][x], SQUARE_VIEW);
+	c->view_grids[c->view_grids_n++] = loc(x, y);
+}
+
 /**
  * Like it says on the tin
  */
@@ -454,8 +675,7 @@ static void add_monster_lights(struct chunk *c, struct loc from)
 	for (k = 1; k < cave_monster_max(c); k++) {
 		/* Check the k'th monster */
 		struct monster *m = cave_monster(c, k);
-
-		bool in_los = los(c, from.y, from.x, m->fy, m->fx);
+		bool in_los;
 
 		/* Skip dead monsters */
 		if (!m->race)
@@ -465,6 +685,13 @@ static void add_monster_lights(struct chunk *c, struct loc from)
 		if (!rf_has(m->race->flags, RF_HAS_LIGHT))
 			continue;
 
+		/* Skip monsters too far away to light anything in view */
+		if (ABS(m->fy - from.y) > z_info->max_sight + 1 ||
+			ABS(m->fx - from.x) > z_info->max_sight + 1)
+			continue;
+
+		in_los = los(c, from.y, from.x, m->fy, m->fx);
+
 		/* Light a 3x3 box centered on the monster */
 		for (i = -1; i <= 1; i++)
 			for (j = -1; j <= 1; j++) {
@@ -484,8 +711,8 @@ static void add_monster_lights(struct chunk *c, struct loc from)
 					continue;
 
 				/* Mark the square lit and seen */
-				sqinfo_on(c->squares[sy][sx].info, SQUARE_VIEW);
-				sqinfo_on(c->squares[sy][sx].info, SQUARE_SEEN);
+				mark_view(c, sy, sx);
+				sqinfo_on(c->info[sy][sx], SQUARE_SEEN);
 			}
 	}
 }
@@ -496,13 +723,13 @@ static void add_monster_lights(struct chunk *c, struct loc from)
 static void update_one(struct chunk *c, int y, int x, int blind)
 {
 	if (blind)
-		sqinfo_off(c->squares[y][x].info, SQUARE_SEEN);
+		sqinfo_off(c->info[y][x], SQUARE_SEEN);
 
 	/* Square went from unseen -> seen */
 	if (square_isseen(c, y, x) && !square_wasseen(c, y, x)) {
 		if (square_isfeel(c, y, x)) {
 			c->feeling_squares++;
-			sqinfo_off(c->squares[y][x].info, SQUARE_FEEL);
+			sqinfo_off(c->info[y][x], SQUARE_FEEL);
 			/* Don't display feeling if it will display for the new level */
 			if ((c->feeling_squares == z_info->feeling_need) &&
 				!player->upkeep->only_partial) {
@@ -519,7 +746,7 @@ static void update_one(struct chunk *c, int y, int x, int blind)
 	if (!square_isseen(c, y, x) && square_wasseen(c, y, x))
 		square_light_spot(c, y, x);
 
-	sqinfo_off(c->squares[y][x].info, SQUARE_WASSEEN);
+	sqinfo_off(c->info[y][x], SQUARE_WASSEEN);
 }
 
 /**
@@ -532,10 +759,10 @@ static void become_viewable(struct chunk *c, int y, int x, int lit, int py, int
 	if (square_isview(c, y, x))
 		return;
 
-	sqinfo_on(c->squares[y][x].info, SQUARE_VIEW);
+	mark_view(c, y, x);
 
 	if (lit)
-		sqinfo_on(c->squares[y][x].info, SQUARE_SEEN);
+		sqinfo_on(c->info[y][x], SQUARE_SEEN);
 
 	if (square_isglow(c, y, x)) {
 		if (square_iswall(c, y, x)) {
@@ -546,7 +773,7 @@ static void become_viewable(struct chunk *c, int y, int x, int lit, int py, int
 			yc = (y < py) ? (y + 1) : (y > py) ? (y - 1) : y;
 		}
 		if (square_isglow(c, yc, xc))
-			sqinfo_on(c->squares[y][x].info, SQUARE_SEEN);
+			sqinfo_on(c->info[y][x], SQUARE_SEEN);
 	}
 }
 
@@ -629,12 +856,18 @@ static void update_view_one(struct chunk *c, int y, int x, int radius, int py, i
  */
 void update_view(struct chunk *c, struct player *p)
 {
-	int x, y;
+	int x, y, i;
+	int x1, y1, x2, y2;
+	int old_n;
+	bool full = !c->view_grids;
 
 	int radius;
 
 	mark_wasseen(c);
 
+	/* New view grids are listed after the old ones */
+	old_n = c->view_grids_n;
+
 	/* Extract "radius" value */
 	radius = p->state.cur_light;
 
@@ -644,19 +877,45 @@ void update_view(struct chunk *c, struct player *p)
 	add_monster_lights(c, loc(p->px, p->py));
 
 	/* Assume we can view the player grid */
-	sqinfo_on(c->squares[p->py][p->px].info, SQUARE_VIEW);
+	mark_view(c, p->py, p->px);
 	if (radius > 0 || square_isglow(c, p->py, p->px))
-		sqinfo_on(c->squares[p->py][p->px].info, SQUARE_SEEN);
+		sqinfo_on(c->info[p->py][p->px], SQUARE_SEEN);
+
+	/* Only squares within max_sight of the player can be viewed; since
+	 * distance() is never less than the larger axis offset, that bounds
+	 * the search to a box around the player */
+	y1 = MAX(p->py - z_info->max_sight, 0);
+	y2 = MIN(p->py + z_info->max_sight, c->height - 1);
+	x1 = MAX(p->px - z_info->max_sight, 0);
+	x2 = MIN(p->px + z_info->max_sight, c->width - 1);
 
 	/* View squares we have LOS to */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
+	for (y = y1; y <= y2; y++)
+		for (x = x1; x <= x2; x++)
 			update_view_one(c, y, x, radius, p->py, p->px);
 
 	/* Complete the algorithm */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
-			update_one(c, y, x, p->timed[TMD_BLIND]);
+	if (full) {
+		for (y = 0; y < c->height; y++)
+			for (x = 0; x < c->width; x++)
+				update_one(c, y, x, p->timed[TMD_BLIND]);
+	} else {
+		/* Old grids still in view are dealt with as new ones */
+		for (i = 0; i < old_n; i++) {
+			y = c->view_grids[i].y;
+			x = c->view_grids[i].x;
+			if (!square_isview(c, y, x))
+				update_one(c, y, x, p->timed[TMD_BLIND]);
+		}
+		for (i = old_n; i < c->view_grids_n; i++)
+			update_one(c, c->view_grids[i].y, c->view_grids[i].x,
+					   p->timed[TMD_BLIND]);
+	}
+
+	/* Keep just the new view grids */
+	c->view_grids_n -= old_n;
+	memmove(c->view_grids, c->view_grids + old_n,
+			c->view_grids_n * sizeof(struct loc));
 }
 
 
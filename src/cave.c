@@ -290,33 +290,114 @@ void set_terrain(void)
 	FEAT_LAVA = lookup_feat("lava");
 }
 
+/**
+ * Alignment of each array in a chunk's arena, enough for any of their types
+ */
+#define CHUNK_ARENA_ALIGN 16
+
+static size_t arena_round(size_t size)
+{
+	return (size + CHUNK_ARENA_ALIGN - 1) & ~(size_t)(CHUNK_ARENA_ALIGN - 1);
+}
+
+/**
+ * Take the next `size` bytes of an arena
+ */
+static void *arena_take(char **next, size_t size)
+{
+	void *taken = *next;
+	*next += arena_round(size);
+	return taken;
+}
+
 /**
  * Allocate a new chunk of the world
+ *
+ * All the arrays whose size is fixed when the chunk is made come from one
+ * zeroed block, the chunk's arena, so making and freeing a chunk - which
+ * level generation does for every attempt at a level - costs a single
+ * allocation however large the chunk is.
  */
 struct chunk *cave_new(int height, int width) {
-	int y, x;
+	int y;
+	size_t grids = (size_t) height * width;
+	size_t feat_size = (z_info->f_max + 1) * sizeof(int);
+	size_t feat_rows_size = height * sizeof(byte*);
+	size_t feat_grid_size = grids * sizeof(byte);
+	size_t info_rows_size = height * sizeof(bitflag (*)[SQUARE_SIZE]);
+	size_t info_size = grids * SQUARE_SIZE * sizeof(bitflag);
+	size_t mon_rows_size = height * sizeof(s16b*);
+	size_t mon_size = grids * sizeof(s16b);
+	size_t obj_rows_size = height * sizeof(struct object**);
+	size_t obj_size = grids * sizeof(struct object*);
+	size_t trap_rows_size = height * sizeof(struct trap**);
+	size_t trap_size = grids * sizeof(struct trap*);
+	size_t noise_rows_size = height * sizeof(u16b*);
+	size_t noise_size = grids * sizeof(u16b);
+	size_t scent_rows_size = height * sizeof(u32b*);
+	size_t scent_size = grids * sizeof(u32b);
+	size_t projectable_size, monsters_size;
+	char *next;
 
 	struct chunk *c = mem_zalloc(sizeof *c);
 	c->height = height;
 	c->width = width;
-	c->feat_count = mem_zalloc((z_info->f_max + 1) * sizeof(int));
-
-	c->squares = mem_zalloc(c->height * sizeof(struct square*));
-	c->noise.grids = mem_zalloc(c->height * sizeof(u16b*));
-	c->scent.grids = mem_zalloc(c->height * sizeof(u16b*));
-	for (y = 0; y < c->height; y++) {
-		c->squares[y] = mem_zalloc(c->width * sizeof(struct square));
-		for (x = 0; x < c->width; x++) {
-			c->squares[y][x].info = mem_zalloc(SQUARE_SIZE * sizeof(bitflag));
-		}
-		c->noise.grids[y] = mem_zalloc(c->width * sizeof(u16b));
-		c->scent.grids[y] = mem_zalloc(c->width * sizeof(u16b));
+	c->projectable_words = (c->width + 2 * PROJECTABLE_PAD + 63) / 64;
+	projectable_size = height * c->projectable_words * sizeof(u64b);
+	monsters_size = z_info->level_monster_max * sizeof(struct monster);
+
+	c->arena = mem_zalloc(arena_round(feat_size) +
+						  arena_round(feat_rows_size) +
+						  arena_round(feat_grid_size) +
+						  arena_round(info_rows_size) +
+						  arena_round(info_size) +
+						  arena_round(mon_rows_size) +
+						  arena_round(mon_size) +
+						  arena_round(obj_rows_size) +
+						  arena_round(obj_size) +
+						  arena_round(trap_rows_size) +
+						  arena_round(trap_size) +
+						  arena_round(noise_rows_size) +
+						  arena_round(noise_size) +
+						  arena_round(scent_rows_size) +
+						  arena_round(scent_size) +
+						  arena_round(projectable_size) +
+						  arena_round(monsters_size));
+	next = c->arena;
+	c->feat_count = arena_take(&next, feat_size);
+
+	/* Each grid array is one block, with row pointers into it */
+	c->feat = arena_take(&next, feat_rows_size);
+	c->feat[0] = arena_take(&next, feat_grid_size);
+	c->info = arena_take(&next, info_rows_size);
+	c->info[0] = arena_take(&next, info_size);
+	c->mon = arena_take(&next, mon_rows_size);
+	c->mon[0] = arena_take(&next, mon_size);
+	c->obj = arena_take(&next, obj_rows_size);
+	c->obj[0] = arena_take(&next, obj_size);
+	c->trap = arena_take(&next, trap_rows_size);
+	c->trap[0] = arena_take(&next, trap_size);
+	c->noise.grids = arena_take(&next, noise_rows_size);
+	c->noise.grids[0] = arena_take(&next, noise_size);
+	c->scent.grids = arena_take(&next, scent_rows_size);
+	c->scent.grids[0] = arena_take(&next, scent_size);
+	for (y = 1; y < c->height; y++) {
+		c->feat[y] = c->feat[0] + y * c->width;
+		c->info[y] = c->info[0] + y * c->width;
+		c->mon[y] = c->mon[0] + y * c->width;
+		c->obj[y] = c->obj[0] + y * c->width;
+		c->trap[y] = c->trap[0] + y * c->width;
+		c->noise.grids[y] = c->noise.grids[0] + y * c->width;
+		c->scent.grids[y] = c->scent.grids[0] + y * c->width;
 	}
 
+	c->projectable = arena_take(&next, projectable_size);
+
+	/* The object list can grow, so it has its own allocation */
 	c->objects = mem_zalloc(OBJECT_LIST_SIZE * sizeof(struct object*));
 	c->obj_max = OBJECT_LIST_SIZE - 1;
 
-	c->monsters = mem_zalloc(z_info->level_monster_max *sizeof(struct monster));
+	c->monsters = arena_take(&next, monsters_size);
 	c->mon_max = 1;
 	c->mon_current = -1;
 
@@ -332,28 +413,214 @@ void cave_free(struct chunk *c) {
 
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
-			mem_free(c->squares[y][x].info);
-			if (c->squares[y][x].trap)
+			if (c->trap[y][x])
 				square_free_trap(c, y, x);
-			if (c->squares[y][x].obj)
-				object_pile_free(c->squares[y][x].obj);
+			if (c->obj[y][x])
+				object_pile_free(c->obj[y][x]);
 		}
-		mem_free(c->squares[y]);
-		mem_free(c->noise.grids[y]);
-		mem_free(c->scent.grids[y]);
 	}
-	mem_free(c->squares);
-	mem_free(c->noise.grids);
-	mem_free(c->scent.grids);
-
-	mem_free(c->feat_count);
+	mem_free(c->arena);
+	mem_free(c->noise_flow.queue);
 	mem_free(c->objects);
-	mem_free(c->monsters);
+	mem_free(c->mon_schedule.sets);
+	mem_free(c->view_grids);
+	mem_free(c->scratch.values);
+	mem_free(c->scratch.stamps);
 	if (c->name)
 		string_free(c->name);
 	mem_free(c);
 }
 
+/**
+ * Make the first `n` entries of a chunk's scratch array available, all
+ * unset.  The array is only allocated when first wanted, and after that
+ * resetting it just moves the stamp on.
+ */
+void cave_scratch_reset(struct chunk *c, int n)
+{
+	struct chunk_scratch *scratch = &c->scratch;
+
+	if (n > scratch->size) {
+		mem_free(scratch->values);
+		mem_free(scratch->stamps);
+		scratch->size = MAX(n, c->height * c->width);
+		scratch->values = mem_alloc(scratch->size * sizeof(int));
+		scratch->stamps = mem_zalloc(scratch->size * sizeof(u32b));
+		scratch->stamp = 0;
+	}
+
+	/* Clear the stamps by hand only when the stamp wraps round */
+	if (++scratch->stamp == 0) {
+		memset(scratch->stamps, 0, scratch->size * sizeof(u32b));
+		scratch->stamp = 1;
+	}
+}
+
+
+/**
+ * Start spreading noise through a chunk from the given grid.
+ *
+ * Grids get the number of steps it takes for sound to get to them from the
+ * source, which has noise 0 along with any grid sound cannot reach.  Only
+ * the grids reached by the last spread need clearing first; the edges of
+ * the chunk are left alone, as they always have been.
+ */
+void cave_noise_start(struct chunk *c, int y, int x)
+{
+	struct noise_flow *flow = &c->noise_flow;
+	int i;
+
+	if (!flow->queue)
+		flow->queue = mem_zalloc(c->height * c->width * sizeof(int));
+
+	/* Set all the grids to silence */
+	for (i = 0; i < flow->tail; i++) {
+		int gy = flow->queue[i] / c->width;
+		int gx = flow->queue[i] % c->width;
+		if ((gy > 0) && (gy < c->height - 1) && (gx > 0) && (gx < c->width - 1))
+			c->noise.grids[gy][gx] = 0;
+	}
+
+	/* The source makes noise */
+	c->noise.grids[y][x] = 0;
+	flow->queue[0] = y * c->width + x;
+	flow->head = 0;
+	flow->tail = 1;
+	flow->origin = loc(x, y);
+	flow->current = true;
+}
+
+/**
+ * Check whether the noise already spreading through a chunk is from the
+ * given grid, through the terrain as it still is
+ */
+bool cave_noise_current(struct chunk *c, int y, int x)
+{
+	struct noise_flow *flow = &c->noise_flow;
+
+	return flow->queue && flow->current && (flow->origin.y == y) &&
+		(flow->origin.x == x);
+}
+
+/**
+ * Spread noise until grid (y, x) is reached, or until every grid with noise
+ * up to `limit` has been reached.
+ */
+static void cave_noise_spread(struct chunk *c, int y, int x, int limit)
+{
+	struct noise_flow *flow = &c->noise_flow;
+
+	if (!flow->queue) return;
+
+	while (flow->head < flow->tail) {
+		int next_y = flow->queue[flow->head] / c->width;
+		int next_x = flow->queue[flow->head] % c->width;
+		int noise = c->noise.grids[next_y][next_x] + 1;
+		int d;
+
+		/* Done if the grid has been reached */
+		if (square_in_bounds(c, y, x) && (c->noise.grids[y][x] ||
+			((y == flow->origin.y) && (x == flow->origin.x))))
+			break;
+
+		/* Grids are queued in order, so all the ones wanted are done */
+		if (noise > limit) break;
+		flow->head++;
+
+		/* Assign noise to the children and enqueue them */
+		for (d = 0; d < 8; d++)	{
+			/* Child location */
+			int cy = next_y + ddy_ddd[d];
+			int cx = next_x + ddx_ddd[d];
+			if (!square_in_bounds(c, cy, cx)) continue;
+
+			/* Ignore features that don't transmit sound */
+			if (square_isnoflow(c, cy, cx)) continue;
+
+			/* Skip grids that already have noise */
+			if (c->noise.grids[cy][cx] != 0) continue;
+
+			/* Skip the source grid */
+			if ((cy == flow->origin.y) && (cx == flow->origin.x)) continue;
+
+			/* Save the noise */
+			c->noise.grids[cy][cx] = noise;
+
+			/* Enqueue that entry */
+			flow->queue[flow->tail++] = cy * c->width + cx;
+		}
+	}
+}
+
+/**
+ * Finish spreading noise through the terrain as it is now, because it is
+ * about to change.  The noise will be spread afresh next time it is made.
+ */
+void cave_noise_settle(struct chunk *c)
+{
+	cave_noise_spread(c, -1, -1, INT_MAX);
+	c->noise_flow.current = false;
+}
+
+/**
+ * Get the noise at a grid
+ */
+int cave_noise(struct chunk *c, int y, int x)
+{
+	cave_noise_spread(c, y, x, INT_MAX);
+	return c->noise.grids[y][x];
+}
+
+/**
+ * Get the noise at a grid if it is no more than `limit`; for a quieter grid
+ * this returns 0 or some value greater than `limit`.
+ */
+int cave_noise_near(struct chunk *c, int y, int x, int limit)
+{
+	cave_noise_spread(c, y, x, limit);
+	return c->noise.grids[y][x];
+}
+
+/**
+ * Scent strengths are stored alongside the scent clock tick, in the low bits
+ */
+#define SCENT_STRENGTH_BITS 2
+
+/**
+ * Age all the scent in a chunk by one
+ */
+void cave_scent_age(struct chunk *c)
+{
+	c->scent.clock++;
+}
+
+/**
+ * Lay scent at a grid with the given strength; a strength of 0 is the same as
+ * no scent at all, and older scent does not build up from there
+ */
+void cave_scent_lay(struct chunk *c, int y, int x, int strength)
+{
+	assert(strength >= 0 && strength < (1 << SCENT_STRENGTH_BITS));
+
+	if (strength)
+		c->scent.grids[y][x] =
+			(c->scent.clock << SCENT_STRENGTH_BITS) | strength;
+	else
+		c->scent.grids[y][x] = 0;
+}
+
+/**
+ * Get the scent at a grid, which is the strength it was laid at plus the
+ * number of times it has been aged since, or 0 if there is none
+ */
+int cave_scent(struct chunk *c, int y, int x)
+{
+	u32b stamp = c->scent.grids[y][x];
+	u32b strength = stamp & ((1 << SCENT_STRENGTH_BITS) - 1);
+
+	if (!stamp) return 0;
+	return c->scent.clock - (stamp >> SCENT_STRENGTH_BITS) + strength;
+}
 
 /**
  * Enter an object in the list of objects for the current level/chunk.  This
@@ -432,13 +699,13 @@ void object_lists_check_integrity(struct chunk *c, struct chunk *c_k)
 		if (obj) {
 			assert(obj->oidx == i);
 			if (obj->iy && obj->ix)
-				assert(pile_contains(c->squares[obj->iy][obj->ix].obj, obj));
+				assert(pile_contains(c->obj[obj->iy][obj->ix], obj));
 		}
 		if (known_obj) {
 			assert (obj);
 			assert(known_obj == obj->known);
 			if (known_obj->iy && known_obj->ix)
-				assert (pile_contains(c_k->squares[known_obj->iy][known_obj->ix].obj, known_obj));
+				assert (pile_contains(c_k->obj[known_obj->iy][known_obj->ix], known_obj));
 			assert (known_obj->oidx == i);
 		}
 	}
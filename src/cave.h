@@ -138,20 +138,73 @@ struct grid_data {
 	bool hallucinate;
 };
 
-struct square {
-	byte feat;
-	bitflag *info;
-	s16b mon;
-	struct object *obj;
-	struct trap *trap;
-};
-
+/**
+ * The rows of each of a chunk's grid arrays and heatmaps are laid out one
+ * after another in a single block, which the row pointers index into.
+ */
 struct heatmap {
     u16b **grids;
 };
 
+/**
+ * The spread of the player's noise through a chunk.  This is a breadth-first
+ * search which is only carried out as far as has been needed, so the noise
+ * heatmap is only valid when read through cave_noise() or cave_noise_near().
+ */
+struct noise_flow {
+	int *queue;			/* Grids reached, in order of noise */
+	int head;			/* Next grid to spread noise from */
+	int tail;			/* Number of grids reached */
+	struct loc origin;	/* Where the noise comes from */
+	bool current;		/* Whether the terrain is unchanged since the start */
+};
+
+/**
+ * The player's scent trail.  Rather than ageing every grid each time scent is
+ * laid, each grid records the tick of the scent clock when it was laid along
+ * with the strength it was laid at, so it need only be read through
+ * cave_scent() to find its age.  A grid holding zero has no scent.
+ */
+struct scent_map {
+	u32b **grids;
+	u32b clock;			/* Number of times scent has been laid */
+};
+
+/**
+ * Scratch space of one int per grid, kept with a chunk for generation code
+ * that needs a temporary array over (part of) the chunk.  An entry is only
+ * valid if its stamp is the current one, so moving the stamp on resets the
+ * whole array at once; an unset entry reads as its own index.
+ */
+struct chunk_scratch {
+	int *values;
+	u32b *stamps;
+	u32b stamp;
+	int size;
+};
+
+/**
+ * Which monsters process_monsters() has to look at on which game turns.  Each
+ * set is a bitmap over monster indices; there is one set for each of a fixed
+ * number of upcoming game turns, one for the monsters to look at this turn, one
+ * for the monsters marked as handled this turn and one for dormant monsters.
+ */
+struct monster_schedule {
+	u64b *sets;			/* All the sets, or NULL if not yet in use */
+	int words;			/* Words per set */
+	s32b turn;			/* Game turn the current set was made for */
+	int pass;			/* Monster the full pass has reached this turn */
+	int early_pass;		/* Monster the current early pass has reached */
+	int early_min;		/* Least energy to move in the current early pass */
+	int early_least;	/* Least energy to move in finished early passes */
+	int player_y;		/* Where the player was when dormant monsters */
+	int player_x;		/*   were last checked, and their stealth */
+	int player_stealth;
+};
+
 struct chunk {
 	char *name;
+	void *arena;			/* Block holding the chunk's fixed-size arrays */
 	s32b created_at;
 	int depth;
 
@@ -166,9 +219,17 @@ struct chunk {
 	u16b feeling_squares; /* How many feeling squares the player has visited */
 	int *feat_count;
 
-	struct square **squares;
+	/* What is on each grid, one array per property */
+	byte **feat;					/* Terrain */
+	bitflag (**info)[SQUARE_SIZE];	/* SQUARE_* flags */
+	s16b **mon;						/* Monster index, or -1 for the player */
+	struct object ***obj;			/* Object pile */
+	struct trap ***trap;			/* Trap list */
+	u64b *projectable;		/* Bitplane of projectable grids, for los() */
+	int projectable_words;	/* Words per row of the projectable bitplane */
 	struct heatmap noise;
-	struct heatmap scent;
+	struct noise_flow noise_flow;
+	struct scent_map scent;
 
 	struct object **objects;
 	u16b obj_max;
@@ -177,8 +238,20 @@ struct chunk {
 	u16b mon_max;
 	u16b mon_cnt;
 	int mon_current;
+	struct monster_schedule mon_schedule;
+
+	struct loc *view_grids;	/* Grids marked SQUARE_VIEW by update_view() */
+	int view_grids_n;
+
+	struct chunk_scratch scratch;
 };
 
+/**
+ * Columns of padding either side of each row of the projectable bitplane,
+ * so that los() can always read a full word around a grid
+ */
+#define PROJECTABLE_PAD 64
+
 /*** Feature Indexes (see "lib/gamedata/terrain.txt") ***/
 
 /* Nothing */
@@ -213,13 +286,31 @@ extern int FEAT_LAVA;
 
 /* Current level */
 extern struct chunk *cave;
+/**
+ * A chunk put away for later.  Only its savefile encoding is kept, and that
+ * is compressed with lz_compress() when it comes out smaller; the chunk is
+ * rebuilt when it is wanted.
+ */
+struct stored_chunk {
+	char *name;
+	byte *data;
+	u32b len;			/* Bytes in data */
+	u32b raw_len;		/* Bytes in the encoding; len if it isn't compressed */
+	u32b terrain_len;	/* Bytes at the start of the encoding for the terrain */
+
+	struct stored_chunk *next;		/* Next in the order they were stored */
+	struct stored_chunk *prev;
+	struct stored_chunk *hash_next;	/* Next with the same hash of its name */
+};
+
 /* Stored levels */
-extern struct chunk **chunk_list;
+extern struct stored_chunk *chunk_list;
 extern u16b chunk_list_max;
 
 /* cave-view.c */
 int distance(int y1, int x1, int y2, int x2);
 bool los(struct chunk *c, int y1, int x1, int y2, int x2);
+void update_projectable(struct chunk *c, int y, int x);
 void update_view(struct chunk *c, struct player *p);
 bool no_light(void);
 
@@ -388,6 +479,7 @@ int lookup_feat(const char *name);
 void set_terrain(void);
 struct chunk *cave_new(int height, int width);
 void cave_free(struct chunk *c);
+void cave_scratch_reset(struct chunk *c, int n);
 void list_object(struct chunk *c, struct object *obj);
 void delist_object(struct chunk *c, struct object *obj);
 void object_lists_check_integrity(struct chunk *c, struct chunk *c_k);
@@ -399,6 +491,15 @@ int cave_monster_count(struct chunk *c);
 
 int count_feats(int *y, int *x, bool (*test)(struct chunk *cave, int y, int x), bool under);
 
+void cave_noise_start(struct chunk *c, int y, int x);
+bool cave_noise_current(struct chunk *c, int y, int x);
+void cave_noise_settle(struct chunk *c);
+int cave_noise(struct chunk *c, int y, int x);
+int cave_noise_near(struct chunk *c, int y, int x, int limit);
+void cave_scent_age(struct chunk *c);
+void cave_scent_lay(struct chunk *c, int y, int x, int strength);
+int cave_scent(struct chunk *c, int y, int x);
+
 void cave_generate(struct chunk **c, struct player *p);
 bool is_quest(int level);
 
@@ -416,7 +416,7 @@ void do_cmd_close(struct command *cmd)
 	}
 
 	/* Monster - alert, then attack */
-	if (cave->squares[y][x].mon > 0) {
+	if (cave->mon[y][x] > 0) {
 		msg("There is a monster in the way!");
 		py_attack(player, y, x);
 	} else
@@ -589,7 +589,7 @@ void do_cmd_tunnel(struct command *cmd)
 	}
 
 	/* Attack any monster we run into */
-	if (cave->squares[y][x].mon > 0) {
+	if (cave->mon[y][x] > 0) {
 		msg("There is a monster in the way!");
 		py_attack(player, y, x);
 	} else {
@@ -693,7 +693,7 @@ static bool do_cmd_lock_door(int y, int x)
 static bool do_cmd_disarm_aux(int y, int x)
 {
 	int skill, power, chance;
-    struct trap *trap = cave->squares[y][x].trap;
+    struct trap *trap = cave->trap[y][x];
 	bool more = false;
 
 	/* Verify legality */
@@ -814,7 +814,7 @@ void do_cmd_disarm(struct command *cmd)
 
 
 	/* Monster */
-	if (cave->squares[y][x].mon > 0) {
+	if (cave->mon[y][x] > 0) {
 		msg("There is a monster in the way!");
 		py_attack(player, y, x);
 	} else if (obj)
@@ -863,7 +863,7 @@ void do_cmd_alter_aux(int dir)
 	}
 
 	/* Action depends on what's there */
-	if (cave->squares[y][x].mon > 0)
+	if (cave->mon[y][x] > 0)
 		/* Attack monsters */
 		py_attack(player, y, x);
 	else if (square_isdiggable(cave, y, x))
@@ -907,7 +907,7 @@ void move_player(int dir, bool disarm)
 	int y = player->py + ddy[dir];
 	int x = player->px + ddx[dir];
 
-	int m_idx = cave->squares[y][x].mon;
+	int m_idx = cave->mon[y][x];
 	struct monster *mon = cave_monster(cave, m_idx);
 	bool trapsafe = player->timed[TMD_TRAPSAFE];
 	bool alterable = square_isdisarmabletrap(cave, y, x) ||
@@ -1044,7 +1044,7 @@ void move_player(int dir, bool disarm)
  */
 static bool do_cmd_walk_test(int y, int x)
 {
-	int m_idx = cave->squares[y][x].mon;
+	int m_idx = cave->mon[y][x];
 	struct monster *mon = cave_monster(cave, m_idx);
 
 	/* Allow attack on visible monsters if unafraid */
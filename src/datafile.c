@@ -80,7 +80,7 @@ errr parse_file_quit_not_found(struct parser *p, const char *filename) {
  */
 errr parse_file(struct parser *p, const char *filename) {
 	char path[1024];
-	char buf[1024];
+	const char *line;
 	ang_file *fh;
 	errr r = 0;
 
@@ -101,8 +101,8 @@ errr parse_file(struct parser *p, const char *filename) {
 		return PARSE_ERROR_NO_FILE_FOUND;
 
 	/* Parse it */
-	while (file_getl(fh, buf, sizeof(buf))) {
-		r = parser_parse(p, buf);
+	while ((line = file_nextl(fh, NULL))) {
+		r = parser_parse(p, line);
 		if (r)
 			break;
 	}
@@ -26,6 +26,7 @@
 #include "mon-desc.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-msg.h"
 #include "mon-predicate.h"
 #include "mon-spell.h"
@@ -1468,7 +1469,7 @@ bool effect_handler_DETECT_TRAPS(effect_handler_context_t *context)
 				}
 			}
 			/* Mark as trap-detected */
-			sqinfo_on(cave->squares[y][x].info, SQUARE_DTRAP);
+			sqinfo_on(cave->info[y][x], SQUARE_DTRAP);
 		}
 	}
 
@@ -2645,13 +2646,13 @@ bool effect_handler_THRUST_AWAY(effect_handler_context_t *context)
 			xx = x + ddx_ddd[d % 8];
 
 			/* Cannot switch places with stronger monsters. */
-			if (cave->squares[yy][xx].mon != 0) {
+			if (cave->mon[yy][xx] != 0) {
 				/* A monster is trying to pass. */
-				if (cave->squares[y][x].mon > 0) {
+				if (cave->mon[y][x] > 0) {
 
 					struct monster *mon = square_monster(cave, y, x);
 
-					if (cave->squares[yy][xx].mon > 0) {
+					if (cave->mon[yy][xx] > 0) {
 						struct monster *mon1 = square_monster(cave, yy, xx);
 
 						/* Monsters cannot pass by stronger monsters. */
@@ -2665,8 +2666,8 @@ bool effect_handler_THRUST_AWAY(effect_handler_context_t *context)
 				}
 
 				/* The player is trying to pass. */
-				if (cave->squares[y][x].mon < 0) {
-					if (cave->squares[yy][xx].mon > 0) {
+				if (cave->mon[y][x] < 0) {
+					if (cave->mon[yy][xx] > 0) {
 						struct monster *mon1 = square_monster(cave, yy, xx);
 
 						/* Players cannot pass by stronger monsters. */
@@ -2697,7 +2698,7 @@ bool effect_handler_THRUST_AWAY(effect_handler_context_t *context)
 				/* If there are walls everywhere, stop here. */
 				else if (d == (8 + first_d - 1)) {
 					/* Message for player. */
-					if (cave->squares[y][x].mon < 0)
+					if (cave->mon[y][x] < 0)
 						msg("You come to rest next to a wall.");
 					i = grids_away;
 				}
@@ -2717,7 +2718,7 @@ bool effect_handler_THRUST_AWAY(effect_handler_context_t *context)
 
 	/* Some special messages or effects for player or monster. */
 	if (square_isfiery(cave, y, x)) {
-		if (cave->squares[y][x].mon < 0) {
+		if (cave->mon[y][x] < 0) {
 			int base_dam = 100 + randint1(100);
 			int res = player->state.el_info[ELEM_FIRE].res_level;
 			int dam = adjust_dam(player, ELEM_FIRE, base_dam, RANDOMISE, res);
@@ -2725,7 +2726,7 @@ bool effect_handler_THRUST_AWAY(effect_handler_context_t *context)
 			msg("You are thrown into molten lava!");
 			take_hit(player, dam, "being hurled into lava");
 			inven_damage(player, PROJ_FIRE, dam);
-		} else if (cave->squares[y][x].mon > 0) {
+		} else if (cave->mon[y][x] > 0) {
 			struct monster *mon = square_monster(cave, y, x);
 			bool fear = false;
 
@@ -2740,7 +2741,7 @@ bool effect_handler_THRUST_AWAY(effect_handler_context_t *context)
 	}
 
 	/* Clear the projection mark. */
-	sqinfo_off(cave->squares[y][x].info, SQUARE_PROJECT);
+	sqinfo_off(cave->info[y][x], SQUARE_PROJECT);
 
 	return true;
 }
@@ -2847,7 +2848,7 @@ bool effect_handler_TELEPORT(effect_handler_context_t *context)
 	monster_swap(y_start, x_start, y, x);
 
 	/* Clear any projection marker to prevent double processing */
-	sqinfo_off(cave->squares[y][x].info, SQUARE_PROJECT);
+	sqinfo_off(cave->info[y][x], SQUARE_PROJECT);
 
 	/* Lots of updates after monster_swap */
 	handle_stuff(player);
@@ -2915,7 +2916,7 @@ bool effect_handler_TELEPORT_TO(effect_handler_context_t *context)
 	monster_swap(py, px, y, x);
 
 	/* Clear any projection marker to prevent double processing */
-	sqinfo_off(cave->squares[y][x].info, SQUARE_PROJECT);
+	sqinfo_off(cave->info[y][x], SQUARE_PROJECT);
 
 	/* Lots of updates after monster_swap */
 	handle_stuff(player);
@@ -3070,12 +3071,12 @@ bool effect_handler_DESTRUCTION(effect_handler_context_t *context)
 			if (k > r) continue;
 
 			/* Lose room and vault */
-			sqinfo_off(cave->squares[y][x].info, SQUARE_ROOM);
-			sqinfo_off(cave->squares[y][x].info, SQUARE_VAULT);
+			sqinfo_off(cave->info[y][x], SQUARE_ROOM);
+			sqinfo_off(cave->info[y][x], SQUARE_VAULT);
 
 			/* Forget completely */
-			sqinfo_off(cave->squares[y][x].info, SQUARE_GLOW);
-			sqinfo_off(cave->squares[y][x].info, SQUARE_SEEN);
+			sqinfo_off(cave->info[y][x], SQUARE_GLOW);
+			sqinfo_off(cave->info[y][x], SQUARE_SEEN);
 			square_forget(cave, y, x);
 			square_light_spot(cave, y, x);
 
@@ -3187,12 +3188,12 @@ bool effect_handler_EARTHQUAKE(effect_handler_context_t *context)
 			if (distance(centre.y, centre.x, yy, xx) > r) continue;
 
 			/* Lose room and vault */
-			sqinfo_off(cave->squares[yy][xx].info, SQUARE_ROOM);
-			sqinfo_off(cave->squares[yy][xx].info, SQUARE_VAULT);
+			sqinfo_off(cave->info[yy][xx], SQUARE_ROOM);
+			sqinfo_off(cave->info[yy][xx], SQUARE_VAULT);
 
 			/* Forget completely */
-			sqinfo_off(cave->squares[yy][xx].info, SQUARE_GLOW);
-			sqinfo_off(cave->squares[yy][xx].info, SQUARE_SEEN);
+			sqinfo_off(cave->info[yy][xx], SQUARE_GLOW);
+			sqinfo_off(cave->info[yy][xx], SQUARE_SEEN);
 			square_forget(cave, yy, xx);
 			square_light_spot(cave, yy, xx);
 
@@ -3299,7 +3300,7 @@ bool effect_handler_EARTHQUAKE(effect_handler_context_t *context)
 			if (!map[16 + yy - centre.y][16 + xx - centre.x]) continue;
 
 			/* Process monsters */
-			if (cave->squares[yy][xx].mon > 0) {
+			if (cave->mon[yy][xx] > 0) {
 				struct monster *mon = square_monster(cave, yy, xx);
 
 				/* Most monsters cannot co-exist with rock */
@@ -3358,6 +3359,7 @@ bool effect_handler_EARTHQUAKE(effect_handler_context_t *context)
 
 					/* Apply damage directly */
 					mon->hp -= damage;
+					monster_end_dormancy(cave, mon);
 
 					/* Delete (not kill) "dead" monsters */
 					if (mon->hp < 0) {
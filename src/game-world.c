@@ -37,7 +37,6 @@
 #include "source.h"
 #include "target.h"
 #include "trap.h"
-#include "z-queue.h"
 
 u16b daycount = 0;
 u32b seed_randart;		/* Hack -- consistent random artifacts */
@@ -320,64 +319,16 @@ static void decrease_timeouts(void)
  * values, thereby homing in on the player even though twisty tunnels and
  * mazes.  Monsters have a hearing value, which is the largest sound value
  * they can detect.
+ *
+ * The noise only spreads as far as monsters ask for it (see cave_noise()),
+ * and if the player is where they were last time and sound-carrying terrain
+ * has not changed since, the noise already there is still right.
  */
 static void make_noise(struct player *p)
 {
-	int next_y = p->py;
-	int next_x = p->px;
-	int y, x, d;
-	int noise = 0;
-    struct queue *queue = q_new(cave->height * cave->width);
-
-	/* Set all the grids to silence */
-	for (y = 1; y < cave->height - 1; y++) {
-		for (x = 1; x < cave->width - 1; x++) {
-			cave->noise.grids[y][x] = 0;
-		}
-	}
-
-	/* Player makes noise */
-	cave->noise.grids[next_y][next_x] = noise;
-	q_push_int(queue, yx_to_i(next_y, next_x, cave->width));
-	noise++;
-
-	/* Propagate noise */
-	while (q_len(queue) > 0) {
-		/* Get the next grid */
-		i_to_yx(q_pop_int(queue), cave->width, &next_y, &next_x);
-
-		/* If we've reached the current noise level, put it back and step */
-		if (cave->noise.grids[next_y][next_x] == noise) {
-			q_push_int(queue, yx_to_i(next_y, next_x, cave->width));
-			noise++;
-			continue;
-		}
-
-		/* Assign noise to the children and enqueue them */
-		for (d = 0; d < 8; d++)	{
-			/* Child location */
-			y = next_y + ddy_ddd[d];
-			x = next_x + ddx_ddd[d];
-			if (!square_in_bounds(cave, y, x)) continue;
-
-			/* Ignore features that don't transmit sound */
-			if (square_isnoflow(cave, y, x)) continue;
-
-			/* Skip grids that already have noise */
-			if (cave->noise.grids[y][x] != 0) continue;
+	if (cave_noise_current(cave, p->py, p->px)) return;
 
-			/* Skip the player grid */
-			if (y == player->py && x == player->px) continue;
-
-			/* Save the noise */
-			cave->noise.grids[y][x] = noise;
-
-			/* Enqueue that entry */
-			q_push_int(queue, yx_to_i(y, x, cave->width));
-		}
-	}
-
-	q_free(queue);
+	cave_noise_start(cave, p->py, p->px);
 }
 
 /**
@@ -405,14 +356,8 @@ static void update_scent(void)
 		{2, 2, 2, 2, 2},
 	};
 
-	/* Update scent for all grids */
-	for (y = 1; y < cave->height - 1; y++) {
-		for (x = 1; x < cave->width - 1; x++) {
-			if (cave->scent.grids[y][x] > 0) {
-				cave->scent.grids[y][x]++;
-			}
-		}
-	}
+	/* Age the existing scent */
+	cave_scent_age(cave);
 
 	/* Lay down new scent around the player */
 	for (y = 0; y < 5; y++) {
@@ -442,7 +387,7 @@ static void update_scent(void)
 				}
 
 				/* Adjacent to a closer grid, so valid */
-				if (cave->scent.grids[adj_y][adj_x] == new_scent - 1) {
+				if (cave_scent(cave, adj_y, adj_x) == new_scent - 1) {
 					add_scent = true;
 				}
 			}
@@ -453,7 +398,7 @@ static void update_scent(void)
 			}
 
 			/* Mark the scent */
-			cave->scent.grids[scent_y][scent_x] = new_scent;
+			cave_scent_lay(cave, scent_y, scent_x, new_scent);
 		}
 	}
 }
@@ -624,7 +569,7 @@ void process_world(struct chunk *c)
 	/* Decrease trap timeouts */
 	for (y = 0; y < cave->height; y++) {
 		for (x = 0; x < cave->width; x++) {
-			struct trap *trap = cave->squares[y][x].trap;
+			struct trap *trap = cave->trap[y][x];
 			while (trap) {
 				if (trap->timeout) {
 					trap->timeout--;
@@ -991,6 +936,26 @@ void run_game_loop(void)
 
 			/* Count game turns */
 			turn++;
+
+			/* Skip straight to the next turn on which something could
+			 * happen: a monster is due to act, the world is processed or
+			 * the player has the energy to move.  Only energy is gained
+			 * on the turns between, so the player's is added in bulk and
+			 * the monsters' is worked out when they are next looked at.
+			 * Regeneration and timeouts stay on the world's ticks, since
+			 * each tick draws on the RNG and may disturb the player. */
+			if (!player->upkeep->generate_level &&
+				player->energy < z_info->move_energy) {
+				int gain = turn_energy(player->state.speed);
+				s32b next = MIN(monsters_next_turn(cave),
+								turn + (10 - turn % 10) % 10);
+
+				if (gain > 0)
+					next = MIN(next, turn + (z_info->move_energy -
+											 player->energy + gain - 1) / gain);
+				player->energy += (next - turn) * gain;
+				turn = next;
+			}
 		}
 
 		/* Make a new level if requested */
@@ -83,8 +83,8 @@
  */
 static bool square_is_granite_with_flag(struct chunk *c, int y, int x, int flag)
 {
-	if (c->squares[y][x].feat != FEAT_GRANITE) return false;
-	if (!sqinfo_has(c->squares[y][x].info, flag)) return false;
+	if (c->feat[y][x] != FEAT_GRANITE) return false;
+	if (!sqinfo_has(c->info[y][x], flag)) return false;
 
 	return true;
 }
@@ -749,7 +749,7 @@ struct chunk *labyrinth_chunk(int depth, int h, int w, bool lit, bool soft)
 			int k_local = yx_to_i(y, x, w);
 			sets[k_local] = k_local;
 			square_set_feat(c, y + 1, x + 1, FEAT_FLOOR);
-			if (lit) sqinfo_on(c->squares[y + 1][x + 1].info, SQUARE_GLOW);
+			if (lit) sqinfo_on(c->info[y + 1][x + 1], SQUARE_GLOW);
 		}
     }
 
@@ -778,7 +778,7 @@ struct chunk *labyrinth_chunk(int depth, int h, int w, bool lit, bool soft)
 			int sa = sets[a];
 			int sb = sets[b];
 			square_set_feat(c, y_local + 1, x_local + 1, FEAT_FLOOR);
-			if (lit) sqinfo_on(c->squares[y_local + 1][x_local + 1].info, SQUARE_GLOW);
+			if (lit) sqinfo_on(c->info[y_local + 1][x_local + 1], SQUARE_GLOW);
 
 			for (k = 0; k < n; k++) {
 				if (sets[k] == sb) sets[k] = sa;
@@ -959,7 +959,7 @@ static void mutate_cavern(struct chunk *c) {
 			else if (count < 4)
 				temp[y * w + x] = FEAT_FLOOR;
 			else
-				temp[y * w + x] = c->squares[y][x].feat;
+				temp[y * w + x] = c->feat[y][x];
 		}
     }
 
@@ -1014,7 +1014,7 @@ static void glow_point(struct chunk *c, int y, int x) {
     int i, j;
     for (i = -1; i <= -1; i++)
 		for (j = -1; j <= -1; j++)
-			sqinfo_on(c->squares[y + i][x + j].info, SQUARE_GLOW);
+			sqinfo_on(c->info[y + i][x + j], SQUARE_GLOW);
 }
 #endif
 
@@ -1486,7 +1486,7 @@ static void town_gen_layout(struct chunk *c, struct player *p)
 	for (y = 1; y < c->height - 1; y++) {
 		for (x = 1; x < c->width - 1; x++) {
 			if (square_isfloor(c, y, x))
-				sqinfo_off(c->squares[y][x].info, SQUARE_ROOM);
+				sqinfo_off(c->info[y][x], SQUARE_ROOM);
 			else if (!square_isperm(c, y, x) && !square_isfiery(c, y, x))
 				square_set_feat(c, y, x, FEAT_PERM);
 		}
@@ -1566,27 +1566,27 @@ struct chunk *town_gen(struct player *p)
 	int i, y, x = 0;
 	int residents = is_daytime() ? z_info->town_monsters_day :
 		z_info->town_monsters_night;
-	struct chunk *c_new, *c_old = chunk_find_name("Town");
+	struct chunk *c_new;
 
 	/* Make a new chunk */
 	c_new = cave_new(z_info->town_hgt, z_info->town_wid);
 
 	/* First time */
-	if (!c_old) {
+	if (!chunk_find_name("Town")) {
 		c_new->depth = p->depth;
 
 		/* Build stuff */
 		town_gen_layout(c_new, p);
 	} else {
 		/* Copy from the chunk list */
-		if (!chunk_copy(c_new, c_old, 0, 0, 0, 0))
+		if (!chunk_restore(c_new, "Town", 0, 0, 0, false))
 			quit_fmt("chunk_copy() level bounds failed!");
 
 		/* Find the stairs (lame) */
 		for (y = 0; y < c_new->height; y++) {
 			bool found = false;
 			for (x = 0; x < c_new->width; x++) {
-				if (c_new->squares[y][x].feat == FEAT_MORE) {
+				if (c_new->feat[y][x] == FEAT_MORE) {
 					found = true;
 					break;
 				}
@@ -18,6 +18,8 @@
  * This file maintains a list of saved chunks of world which can be reloaded
  * at any time.  The intitial example of this is the town, which is saved 
  * immediately after generation and restored when the player returns there.
+ * Saved chunks are kept compressed in their savefile encoding, and only
+ * rebuilt when they are restored.
  *
  * The copying routines are also useful for generating a level in pieces and
  * then copying those pieces into the actual level chunk.
@@ -29,11 +31,15 @@
 #include "init.h"
 #include "mon-make.h"
 #include "obj-util.h"
+#include "savefile.h"
 #include "trap.h"
+#include "z-lz.h"
 
-#define CHUNK_LIST_INCR 10
-struct chunk **chunk_list;     /**< list of pointers to saved chunks */
-u16b chunk_list_max = 0;      /**< current max actual chunk index */
+#define CHUNK_HASH_SIZE 64
+struct stored_chunk *chunk_list;	/**< saved chunks, in the order saved */
+u16b chunk_list_max = 0;			/**< number of saved chunks */
+static struct stored_chunk *chunk_list_last;
+static struct stored_chunk *chunk_hash[CHUNK_HASH_SIZE];	/**< by name */
 
 /**
  * Write a chunk to memory and return a pointer to it.  Optionally write
@@ -59,15 +65,16 @@ struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 	for (y = 0; y < height; y++) {
 		for (x = 0; x < width; x++) {
 			/* Terrain */
-			new->squares[y][x].feat = cave->squares[y0 + y][x0 + x].feat;
-			sqinfo_copy(new->squares[y][x].info,
-						cave->squares[y0 + y][x0 + x].info);
+			new->feat[y][x] = cave->feat[y0 + y][x0 + x];
+			update_projectable(new, y, x);
+			sqinfo_copy(new->info[y][x],
+						cave->info[y0 + y][x0 + x]);
 
 			/* Dungeon objects */
 			if (objects) {
 				struct object *obj = square_object(cave, y0 + y, x0 + x);
 				if (obj) {
-					new->squares[y][x].obj = obj;
+					new->obj[y][x] = obj;
 					while (obj) {
 						/* Adjust stuff */
 						obj->iy = y;
@@ -78,7 +85,7 @@ struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 
 			/* Monsters and held objects */
 			if (monsters) {
-				if (cave->squares[y0 + y][x0 + x].mon > 0) {
+				if (cave->mon[y0 + y][x0 + x] > 0) {
 					struct monster *source_mon = square_monster(cave, y0 + y,
 															  x0 + x);
 					struct monster *dest_mon = NULL;
@@ -88,7 +95,7 @@ struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 						continue;
 
 					/* Copy over */
-					new->squares[y][x].mon = ++new->mon_cnt;
+					new->mon[y][x] = ++new->mon_cnt;
 					dest_mon = cave_monster(new, new->mon_cnt);
 					memcpy(dest_mon, source_mon, sizeof(*source_mon));
 
@@ -107,9 +114,9 @@ struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 			/* Traps */
 			if (traps) {
 				/* Copy over */
-				struct trap *trap = cave->squares[y][x].trap;
-				new->squares[y][x].trap = trap;
-				cave->squares[y][x].trap = NULL;
+				struct trap *trap = cave->trap[y][x];
+				new->trap[y][x] = trap;
+				cave->trap[y][x] = NULL;
 
 				/* Adjust position */
 				trap->fy = y;
@@ -122,22 +129,76 @@ struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 }
 
 /**
- * Add an entry to the chunk list - any problems with the length of this will
- * be more in the memory used by the chunks themselves rather than the list
+ * Find the hash bucket for a chunk name
+ */
+static struct stored_chunk **chunk_bucket(const char *name)
+{
+	return &chunk_hash[djb2_hash(name) % CHUNK_HASH_SIZE];
+}
+
+/**
+ * Find a saved chunk by name
+ */
+static struct stored_chunk *chunk_lookup(const char *name)
+{
+	struct stored_chunk *s = *chunk_bucket(name);
+
+	while (s && !streq(s->name, name))
+		s = s->hash_next;
+
+	return s;
+}
+
+/**
+ * Add an entry to the chunk list.  The chunk is encoded and freed; it can be
+ * got back with chunk_restore()
  * \param c the chunk being added to the list
  */
 void chunk_list_add(struct chunk *c)
 {
-	int newsize = (chunk_list_max + CHUNK_LIST_INCR) *	sizeof(struct chunk *);
-
-	/* Lengthen the list if necessary */
-	if (chunk_list_max == 0)
-		chunk_list = mem_zalloc(newsize);
-	else if ((chunk_list_max % CHUNK_LIST_INCR) == 0)
-		chunk_list = (struct chunk **) mem_realloc(chunk_list, newsize);
+	struct stored_chunk *s = mem_zalloc(sizeof(*s));
+	struct stored_chunk **bucket;
+	byte *raw;
+	size_t packed = 0;
+
+	assert(c->name);
+
+	/* Keep the encoding, compressed if that makes it smaller */
+	raw = savefile_encode_chunk(c, &s->raw_len, &s->terrain_len);
+	if (s->raw_len > 1) {
+		s->data = mem_alloc(s->raw_len - 1);
+		packed = lz_compress(raw, s->raw_len, s->data, s->raw_len - 1);
+	}
+	if (packed) {
+		s->data = mem_realloc(s->data, packed);
+		s->len = packed;
+		mem_free(raw);
+	} else {
+		mem_free(s->data);
+		s->data = raw;
+		s->len = s->raw_len;
+	}
+	s->name = string_make(c->name);
+	cave_free(c);
 
 	/* Add the new one */
-	chunk_list[chunk_list_max++] = c;
+	s->prev = chunk_list_last;
+	if (chunk_list_last)
+		chunk_list_last->next = s;
+	else
+		chunk_list = s;
+	chunk_list_last = s;
+	bucket = chunk_bucket(s->name);
+	s->hash_next = *bucket;
+	*bucket = s;
+	chunk_list_max++;
+}
+
+static void chunk_list_free_entry(struct stored_chunk *s)
+{
+	string_free(s->name);
+	mem_free(s->data);
+	mem_free(s);
 }
 
 /**
@@ -145,63 +206,74 @@ void chunk_list_add(struct chunk *c)
  * \param name the name of the chunk being removed from the list
  * \return whether it was found; success means it was successfully removed
  */
-bool chunk_list_remove(char *name)
+bool chunk_list_remove(const char *name)
 {
-	int i, j;
-	int newsize = 0;
-
-	for (i = 0; i < chunk_list_max; i++) {
-		/* Find the match */
-		if (!strcmp(name, chunk_list[i]->name)) {
-			/* Copy all the succeeding ones back one */
-			for (j = i + 1; j < chunk_list_max; j++)
-				chunk_list[j - 1] = chunk_list[j];
-
-			/* Destroy the last one, and shorten the list */
-			if ((chunk_list_max % CHUNK_LIST_INCR) == 0)
-				newsize = (chunk_list_max - CHUNK_LIST_INCR) *	
-					sizeof(struct chunk *);
-			chunk_list_max--;
-			chunk_list[chunk_list_max] = NULL;
-			if (newsize)
-				chunk_list = (struct chunk **) mem_realloc(chunk_list, newsize);
-
-			return true;
-		}
-	}
+	struct stored_chunk **bucket = chunk_bucket(name);
+	struct stored_chunk *s;
+
+	/* Find the match */
+	while (*bucket && !streq((*bucket)->name, name))
+		bucket = &(*bucket)->hash_next;
+	s = *bucket;
+	if (!s)
+		return false;
+
+	/* Take it out of both lists */
+	*bucket = s->hash_next;
+	if (s->prev)
+		s->prev->next = s->next;
+	else
+		chunk_list = s->next;
+	if (s->next)
+		s->next->prev = s->prev;
+	else
+		chunk_list_last = s->prev;
+	chunk_list_max--;
+
+	chunk_list_free_entry(s);
+	return true;
+}
 
-	return false;
+/**
+ * Empty the chunk list
+ */
+void chunk_list_free(void)
+{
+	while (chunk_list) {
+		struct stored_chunk *s = chunk_list;
+		chunk_list = s->next;
+		chunk_list_free_entry(s);
+	}
+	chunk_list_last = NULL;
+	chunk_list_max = 0;
+	memset(chunk_hash, 0, sizeof(chunk_hash));
 }
 
 /**
- * Find a chunk by name
- * \param name the name of the chunk being sought
- * \return the pointer to the chunk
+ * Get back the encoding of a saved chunk
+ * \param s the saved chunk
+ * \return the encoding, raw_len bytes long, which the caller frees
  */
-struct chunk *chunk_find_name(char *name)
+byte *chunk_list_encoding(const struct stored_chunk *s)
 {
-	int i;
+	byte *raw = mem_alloc(s->raw_len);
 
-	for (i = 0; i < chunk_list_max; i++)
-		if (!strcmp(name, chunk_list[i]->name))
-			return chunk_list[i];
+	if (s->len == s->raw_len)
+		memcpy(raw, s->data, s->len);
+	else if (!lz_decompress(s->data, s->len, raw, s->raw_len))
+		quit_fmt("Saved chunk %s is corrupt!", s->name);
 
-	return NULL;
+	return raw;
 }
 
 /**
- * Find a chunk by pointer
- * \param c the actual pointer to the sought chunk
+ * Find whether there is a chunk of the given name
+ * \param name the name of the chunk being sought
  * \return if it was found
  */
-bool chunk_find(struct chunk *c)
+bool chunk_find_name(const char *name)
 {
-	int i;
-
-	for (i = 0; i < chunk_list_max; i++)
-		if (c == chunk_list[i]) return true;
-
-	return false;
+	return chunk_lookup(name) != NULL;
 }
 
 /**
@@ -273,25 +345,26 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 			symmetry_transform(&dest_y, &dest_x, y0, x0, h, w, rotate, reflect);
 
 			/* Terrain */
-			dest->squares[dest_y][dest_x].feat = source->squares[y][x].feat;
-			sqinfo_copy(dest->squares[dest_y][dest_x].info,
-						source->squares[y][x].info);
+			dest->feat[dest_y][dest_x] = source->feat[y][x];
+			update_projectable(dest, dest_y, dest_x);
+			sqinfo_copy(dest->info[dest_y][dest_x],
+						source->info[y][x]);
 
 			/* Dungeon objects */
 			if (square_object(source, y, x)) {
 				struct object *obj;
-				dest->squares[dest_y][dest_x].obj = square_object(source, y, x);
+				dest->obj[dest_y][dest_x] = square_object(source, y, x);
 
 				for (obj = square_object(source, y, x); obj; obj = obj->next) {
 					/* Adjust position */
 					obj->iy = dest_y;
 					obj->ix = dest_x;
 				}
-				source->squares[y][x].obj = NULL;
+				source->obj[y][x] = NULL;
 			}
 
 			/* Monsters */
-			if (source->squares[y][x].mon > 0) {
+			if (source->mon[y][x] > 0) {
 				struct monster *source_mon = square_monster(source, y, x);
 				struct monster *dest_mon = NULL;
 				int idx;
@@ -309,7 +382,7 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 
 				/* Copy over */
 				dest_mon = cave_monster(dest, idx);
-				dest->squares[dest_y][dest_x].mon = idx;
+				dest->mon[dest_y][dest_x] = idx;
 				memcpy(dest_mon, source_mon, sizeof(*source_mon));
 
 				/* Adjust stuff */
@@ -323,9 +396,9 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 			}
 
 			/* Traps */
-			if (source->squares[y][x].trap) {
-				struct trap *trap = source->squares[y][x].trap;
-				dest->squares[dest_y][dest_x].trap = trap;
+			if (source->trap[y][x]) {
+				struct trap *trap = source->trap[y][x];
+				dest->trap[dest_y][dest_x] = trap;
 
 				/* Traverse the trap list */
 				while (trap) {
@@ -334,12 +407,12 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 					trap->fx = dest_x;
 					trap = trap->next;
 				}
-				source->squares[y][x].trap = NULL;
+				source->trap[y][x] = NULL;
 			}
 
 			/* Player */
-			if (source->squares[y][x].mon == -1) 
-				dest->squares[dest_y][dest_x].mon = -1;
+			if (source->mon[y][x] == -1) 
+				dest->mon[dest_y][dest_x] = -1;
 		}
 	}
 
@@ -366,6 +439,41 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 	return true;
 }
 
+/**
+ * Rebuild a saved chunk and copy it, transformed, to a given offset in
+ * another chunk.  The saved chunk stays in the list.
+ * \param dest the chunk where the copy is going
+ * \param name the name of the saved chunk
+ * \param y0 transformation parameters  - see symmetry_transform()
+ * \param x0 transformation parameters  - see symmetry_transform()
+ * \param rotate transformation parameters  - see symmetry_transform()
+ * \param reflect transformation parameters  - see symmetry_transform()
+ * \return success - fails if there is no such chunk, or the copy would not
+ * fit in the destination chunk
+ */
+bool chunk_restore(struct chunk *dest, const char *name, int y0, int x0,
+				   int rotate, bool reflect)
+{
+	struct stored_chunk *s = chunk_lookup(name);
+	struct chunk *source;
+	byte *raw;
+	bool copied;
+
+	if (!s)
+		return false;
+
+	raw = chunk_list_encoding(s);
+	source = savefile_decode_chunk(raw, s->raw_len);
+	mem_free(raw);
+	if (!source)
+		quit_fmt("Saved chunk %s is corrupt!", name);
+
+	copied = chunk_copy(dest, source, y0, x0, rotate, reflect);
+	cave_free(source);
+
+	return copied;
+}
+
 /**
  * Validate that the chunk contains no NULL objects.
  * Only checks for nonzero tval.
@@ -380,7 +488,7 @@ void chunk_validate_objects(struct chunk *c) {
 		for (x = 0; x < c->width; x++) {
 			for (obj = square_object(c, y, x); obj; obj = obj->next)
 				assert(obj->tval != 0);
-			if (c->squares[y][x].mon > 0) {
+			if (c->mon[y][x] > 0) {
 				struct monster *mon = square_monster(c, y, x);
 				if (mon->held_obj)
 					for (obj = mon->held_obj; obj; obj = obj->next)
@@ -108,9 +108,9 @@ static void generate_room(struct chunk *c, int y1, int x1, int y2, int x2, int l
 	int y, x;
 	for (y = y1; y <= y2; y++)
 		for (x = x1; x <= x2; x++) {
-			sqinfo_on(c->squares[y][x].info, SQUARE_ROOM);
+			sqinfo_on(c->info[y][x], SQUARE_ROOM);
 			if (light)
-				sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+				sqinfo_on(c->info[y][x], SQUARE_GLOW);
 		}
 }
 
@@ -129,7 +129,7 @@ void generate_mark(struct chunk *c, int y1, int x1, int y2, int x2, int flag)
 
 	for (y = y1; y <= y2; y++) {
 		for (x = x1; x <= x2; x++) {
-			sqinfo_on(c->squares[y][x].info, flag);
+			sqinfo_on(c->info[y][x], flag);
 		}
 	}
 }
@@ -203,10 +203,10 @@ static void fill_xrange(struct chunk *c, int y, int x1, int x2, int feat,
 	int x;
 	for (x = x1; x <= x2; x++) {
 		square_set_feat(c, y, x, feat);
-		sqinfo_on(c->squares[y][x].info, SQUARE_ROOM);
-		if (flag) sqinfo_on(c->squares[y][x].info, flag);
+		sqinfo_on(c->info[y][x], SQUARE_ROOM);
+		if (flag) sqinfo_on(c->info[y][x], flag);
 		if (light)
-			sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+			sqinfo_on(c->info[y][x], SQUARE_GLOW);
 	}
 }
 
@@ -226,10 +226,10 @@ static void fill_yrange(struct chunk *c, int x, int y1, int y2, int feat,
 	int y;
 	for (y = y1; y <= y2; y++) {
 		square_set_feat(c, y, x, feat);
-		sqinfo_on(c->squares[y][x].info, SQUARE_ROOM);
-		if (flag) sqinfo_on(c->squares[y][x].info, flag);
+		sqinfo_on(c->info[y][x], SQUARE_ROOM);
+		if (flag) sqinfo_on(c->info[y][x], flag);
 		if (light)
-			sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+			sqinfo_on(c->info[y][x], SQUARE_GLOW);
 	}
 }
 
@@ -652,14 +652,14 @@ extern bool generate_starburst_room(struct chunk *c, int y1, int x1, int y2,
 							square_set_feat(c, y, x, feat);
 
 							if (feat_is_floor(feat))
-								sqinfo_on(c->squares[y][x].info, SQUARE_ROOM);
+								sqinfo_on(c->info[y][x], SQUARE_ROOM);
 							else
-								sqinfo_off(c->squares[y][x].info, SQUARE_ROOM);
+								sqinfo_off(c->info[y][x], SQUARE_ROOM);
 
 							if (light)
-								sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+								sqinfo_on(c->info[y][x], SQUARE_GLOW);
 							else
-								sqinfo_off(c->squares[y][x].info, SQUARE_GLOW);
+								sqinfo_off(c->info[y][x], SQUARE_GLOW);
 						}
 
 						/* If new feature is non-floor passable terrain,
@@ -678,7 +678,7 @@ extern bool generate_starburst_room(struct chunk *c, int y1, int x1, int y2,
 
 							/* Light grid. */
 							if (light)
-								sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+								sqinfo_on(c->info[y][x], SQUARE_GLOW);
 						}
 					}
 
@@ -705,14 +705,14 @@ extern bool generate_starburst_room(struct chunk *c, int y1, int x1, int y2,
 						int xx = x + ddx_ddd[d];
 
 						/* Join to room */
-						sqinfo_on(c->squares[yy][xx].info, SQUARE_ROOM);
+						sqinfo_on(c->info[yy][xx], SQUARE_ROOM);
 
 						/* Illuminate if requested. */
 						if (light)
-							sqinfo_on(c->squares[yy][xx].info, SQUARE_GLOW);
+							sqinfo_on(c->info[yy][xx], SQUARE_GLOW);
 
 						/* Look for dungeon granite. */
-						if (c->squares[yy][xx].feat == FEAT_GRANITE) {
+						if (c->feat[yy][xx] == FEAT_GRANITE) {
 							/* Mark as outer wall. */
 							set_marked_granite(c, yy, xx, SQUARE_WALL_OUTER);
 						}
@@ -813,7 +813,8 @@ void set_pit_type(int depth, int type)
 		offset = Rand_normal(pit->ave, 10);
 		dist = ABS(offset - depth);
 		
-		if (dist < pit_dist && one_in_(pit->rarity)) {
+		/* The empty pit at the end of the list is never the closest */
+		if (pit->name && dist < pit_dist && one_in_(pit->rarity)) {
 			/* This pit is the closest so far */
 			pit_idx = i;
 			pit_dist = dist;
@@ -1045,9 +1046,9 @@ static bool build_room_template(struct chunk *c, int y0, int x0, int ymax, int x
 			}
 
 			/* Part of a room */
-			sqinfo_on(c->squares[y][x].info, SQUARE_ROOM);
+			sqinfo_on(c->info[y][x], SQUARE_ROOM);
 			if (light)
-				sqinfo_on(c->squares[y][x].info, SQUARE_GLOW);
+				sqinfo_on(c->info[y][x], SQUARE_GLOW);
 		}
 	}
 
@@ -1187,8 +1188,8 @@ bool build_vault(struct chunk *c, int y0, int x0, struct vault *v)
 			}
 
 			/* Part of a vault */
-			sqinfo_on(c->squares[y][x].info, SQUARE_ROOM);
-			if (icky) sqinfo_on(c->squares[y][x].info, SQUARE_VAULT);
+			sqinfo_on(c->info[y][x], SQUARE_ROOM);
+			if (icky) sqinfo_on(c->info[y][x], SQUARE_VAULT);
 		}
 	}
 
@@ -1372,8 +1373,8 @@ static bool build_vault_type(struct chunk *c, int y0, int x0, const char *typ)
  */
 static void make_inner_chamber_wall(struct chunk *c, int y, int x)
 {
-	if ((c->squares[y][x].feat != FEAT_GRANITE) &&
-		(c->squares[y][x].feat != FEAT_MAGMA))
+	if ((c->feat[y][x] != FEAT_GRANITE) &&
+		(c->feat[y][x] != FEAT_MAGMA))
 		return;
 	if (square_iswall_outer(c, y, x)) return;
 	if (square_iswall_solid(c, y, x)) return;
@@ -1447,7 +1448,7 @@ static void make_chamber(struct chunk *c, int y1, int x1, int y2, int x2)
 			int xx = x + ddx_ddd[d];
 
 			/* No doors beside doors. */
-			if (c->squares[yy][xx].feat == FEAT_OPEN)
+			if (c->feat[yy][xx] == FEAT_OPEN)
 				break;
 
 			/* Count the inner walls. */
@@ -1487,14 +1488,14 @@ static void hollow_out_room(struct chunk *c, int y, int x)
 		xx = x + ddx_ddd[d];
 
 		/* Change magma to floor. */
-		if (c->squares[yy][xx].feat == FEAT_MAGMA) {
+		if (c->feat[yy][xx] == FEAT_MAGMA) {
 			square_set_feat(c, yy, xx, FEAT_FLOOR);
 
 			/* Hollow out the room. */
 			hollow_out_room(c, yy, xx);
 		}
 		/* Change open door to broken door. */
-		else if (c->squares[yy][xx].feat == FEAT_OPEN) {
+		else if (c->feat[yy][xx] == FEAT_OPEN) {
 			square_set_feat(c, yy, xx, FEAT_BROKEN);
 
 			/* Hollow out the (new) room. */
@@ -2665,14 +2666,14 @@ bool build_room_of_chambers(struct chunk *c, int y0, int x0, int rating)
 				int xx = x + ddx_ddd[d];
 
 				/* Count the walls and dungeon granite. */
-				if ((c->squares[yy][xx].feat == FEAT_GRANITE) &&
+				if ((c->feat[yy][xx] == FEAT_GRANITE) &&
 					(!square_iswall_outer(c, yy, xx)) &&
 					(!square_iswall_solid(c, yy, xx)))
 					count++;
 			}
 
 			/* Five adjacent walls: Change non-chamber to wall. */
-			if ((count == 5) && (c->squares[y][x].feat != FEAT_MAGMA))
+			if ((count == 5) && (c->feat[y][x] != FEAT_MAGMA))
 				set_marked_granite(c, y, x, SQUARE_WALL_INNER);
 
 			/* More than five adjacent walls: Change anything to wall. */
@@ -2685,7 +2686,7 @@ bool build_room_of_chambers(struct chunk *c, int y0, int x0, int rating)
 	for (i = 0; i < 50; i++) {
 		y = y1 + ABS(y2 - y1) / 4 + randint0(ABS(y2 - y1) / 2);
 		x = x1 + ABS(x2 - x1) / 4 + randint0(ABS(x2 - x1) / 2);
-		if (c->squares[y][x].feat == FEAT_MAGMA)
+		if (c->feat[y][x] == FEAT_MAGMA)
 			break;
 	}
 
@@ -2702,7 +2703,7 @@ bool build_room_of_chambers(struct chunk *c, int y0, int x0, int rating)
 		for (y = y1; y < y2; y++) {
 			for (x = x1; x < x2; x++) {
 				/* Current grid must be magma. */
-				if (c->squares[y][x].feat != FEAT_MAGMA) continue;
+				if (c->feat[y][x] != FEAT_MAGMA) continue;
 
 				/* Stay legal. */
 				if (!square_in_bounds_fully(c, y, x)) continue;
@@ -2725,7 +2726,7 @@ bool build_room_of_chambers(struct chunk *c, int y0, int x0, int rating)
 					if (!square_in_bounds(c, yy2, xx2)) continue;
 
 					/* If we find open floor, place a door. */
-					if (c->squares[yy2][xx2].feat == FEAT_FLOOR) {
+					if (c->feat[yy2][xx2] == FEAT_FLOOR) {
 						joy = true;
 
 						/* Make a broken door in the wall grid. */
@@ -2746,7 +2747,7 @@ bool build_room_of_chambers(struct chunk *c, int y0, int x0, int rating)
 						if (!square_in_bounds(c, yy3, xx3)) continue;
 
 						/* If we /now/ find floor, make a tunnel. */
-						if (c->squares[yy3][xx3].feat == FEAT_FLOOR) {
+						if (c->feat[yy3][xx3] == FEAT_FLOOR) {
 							joy = true;
 
 							/* Turn both wall grids into floor. */
@@ -2772,9 +2773,9 @@ bool build_room_of_chambers(struct chunk *c, int y0, int x0, int rating)
 	/* Turn broken doors into a random kind of door, remove open doors. */
 	for (y = y1; y <= y2; y++) {
 		for (x = x1; x <= x2; x++) {
-			if (c->squares[y][x].feat == FEAT_OPEN)
+			if (c->feat[y][x] == FEAT_OPEN)
 				set_marked_granite(c, y, x, SQUARE_WALL_INNER);
-			else if (c->squares[y][x].feat == FEAT_BROKEN)
+			else if (c->feat[y][x] == FEAT_BROKEN)
 				place_random_door(c, y, x);
 		}
 	}
@@ -2787,7 +2788,7 @@ bool build_room_of_chambers(struct chunk *c, int y0, int x0, int rating)
 		for (x = (x1 - 1 > 0 ? x1 - 1 : 0);
 			 x < (x2 + 2 < c->width ? x2 + 2 : c->width); x++) {
 			if (square_iswall_inner(c, y, x)
-				|| (c->squares[y][x].feat == FEAT_MAGMA)) {
+				|| (c->feat[y][x] == FEAT_MAGMA)) {
 				for (d = 0; d < 9; d++) {
 					/* Extract adjacent location */
 					int yy = y + ddy_ddd[d];
@@ -2797,7 +2798,7 @@ bool build_room_of_chambers(struct chunk *c, int y0, int x0, int rating)
 					if (!square_in_bounds(c, yy, xx)) continue;
 
 					/* No floors allowed */
-					if (c->squares[yy][xx].feat == FEAT_FLOOR) break;
+					if (c->feat[yy][xx] == FEAT_FLOOR) break;
 
 					/* Turn me into dungeon granite. */
 					if (d == 8)
@@ -2814,10 +2815,10 @@ bool build_room_of_chambers(struct chunk *c, int y0, int x0, int rating)
 					if (!square_in_bounds(c, yy, xx)) continue;
 
 					/* Turn into room. */
-					sqinfo_on(c->squares[yy][xx].info, SQUARE_ROOM);
+					sqinfo_on(c->info[yy][xx], SQUARE_ROOM);
 
 					/* Illuminate if requested. */
-					if (light) sqinfo_on(c->squares[yy][xx].info, SQUARE_GLOW);
+					if (light) sqinfo_on(c->info[yy][xx], SQUARE_GLOW);
 				}
 			}
 		}
@@ -2839,7 +2840,7 @@ bool build_room_of_chambers(struct chunk *c, int y0, int x0, int rating)
 					int xx = x + ddx_ddd[d];
 
 					/* Look for dungeon granite */
-					if ((c->squares[yy][xx].feat == FEAT_GRANITE) && 
+					if ((c->feat[yy][xx] == FEAT_GRANITE) && 
 						(!square_iswall_inner(c, y, x)) &&
 						(!square_iswall_outer(c, y, x)) &&
 						(!square_iswall_solid(c, y, x)))
@@ -147,6 +147,23 @@ void shuffle(int *arr, int n)
 }
 
 
+/**
+ * Read entry `i` of a chunk's scratch array; unset entries are their index
+ */
+static int scratch_get(const struct chunk_scratch *scratch, int i)
+{
+	return scratch->stamps[i] == scratch->stamp ? scratch->values[i] : i;
+}
+
+/**
+ * Set entry `i` of a chunk's scratch array
+ */
+static void scratch_set(struct chunk_scratch *scratch, int i, int value)
+{
+	scratch->values[i] = value;
+	scratch->stamps[i] = scratch->stamp;
+}
+
 /**
  * Locate a square in y1 <= y < y2, x1 <= x < x2 which satisfies the given
  * predicate.
@@ -167,25 +184,24 @@ static bool _find_in_range(struct chunk *c, int *y, int y1, int y2, int *x,
     int xd = x2 - x1;
     int i, n = yd * xd;
     bool found = false;
+    struct chunk_scratch *squares = &c->scratch;
 
-    /* Allocate the squares, and randomize their order */
-    int *squares = mem_alloc(n * sizeof(int));
-    for (i = 0; i < n; i++) squares[i] = i;
+    /* Shuffle the squares as they are tested, in the chunk's scratch array
+     * where each one starts out as itself, so only those tested are touched */
+    cave_scratch_reset(c, n);
 
     /* Test each square in (random) order for openness */
     for (i = 0; i < n && !found; i++) {
 		int j = randint0(n - i) + i;
-		int k = squares[j];
-		squares[j] = squares[i];
-		squares[i] = k;
+		int k = scratch_get(squares, j);
+		scratch_set(squares, j, scratch_get(squares, i));
+		scratch_set(squares, i, k);
 
 		*y = (k / xd) + y1;
 		*x = (k % xd) + x1;
 		if (pred(c, *y, *x)) found = true;
     }
 
-	mem_free(squares);
-
     /* Return whether we found an empty square or not. */
     return found;
 }
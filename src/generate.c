@@ -648,7 +648,7 @@ static void place_feeling(struct chunk *c)
 				continue;
 
 			/* Set the cave square appropriately */
-			sqinfo_on(c->squares[y][x].info, SQUARE_FEEL);
+			sqinfo_on(c->info[y][x], SQUARE_FEEL);
 			
 			break;
 		}
@@ -840,6 +840,9 @@ void cave_generate(struct chunk **c, struct player *p)
 	const char *error = "no generation";
 	int i, y, x, tries = 0;
 	struct chunk *chunk = NULL;
+	size_t dun_locs_n = z_info->level_room_max + z_info->level_door_max +
+		z_info->wall_pierce_max + z_info->tunn_grid_max;
+	struct loc *dun_locs;
 
 	assert(c);
 
@@ -877,6 +880,9 @@ void cave_generate(struct chunk **c, struct player *p)
 		*c = NULL;
 	}
 
+	/* Every attempt's location arrays come from one block */
+	dun_locs = mem_alloc(dun_locs_n * sizeof(struct loc));
+
 	/* Generate */
 	for (tries = 0; tries < 100 && error; tries++) {
 		struct dun_data dun_body;
@@ -886,22 +892,19 @@ void cave_generate(struct chunk **c, struct player *p)
 		/* Mark the dungeon as being unready (to avoid artifact loss, etc) */
 		character_dungeon = false;
 
-		/* Allocate global data (will be freed when we leave the loop) */
+		/* Set up global data, with the location arrays cleared */
 		dun = &dun_body;
-		dun->cent = mem_zalloc(z_info->level_room_max * sizeof(struct loc));
-		dun->door = mem_zalloc(z_info->level_door_max * sizeof(struct loc));
-		dun->wall = mem_zalloc(z_info->wall_pierce_max * sizeof(struct loc));
-		dun->tunn = mem_zalloc(z_info->tunn_grid_max * sizeof(struct loc));
+		memset(dun_locs, 0, dun_locs_n * sizeof(struct loc));
+		dun->cent = dun_locs;
+		dun->door = dun->cent + z_info->level_room_max;
+		dun->wall = dun->door + z_info->level_door_max;
+		dun->tunn = dun->wall + z_info->wall_pierce_max;
 
 		/* Choose a profile and build the level */
 		dun->profile = choose_profile(p->depth);
 		chunk = dun->profile->builder(p);
 		if (!chunk) {
 			error = "Failed to find builder";
-			mem_free(dun->cent);
-			mem_free(dun->door);
-			mem_free(dun->wall);
-			mem_free(dun->tunn);
 			continue;
 		}
 
@@ -926,10 +929,10 @@ void cave_generate(struct chunk **c, struct player *p)
 		/* Clear generation flags. */
 		for (y = 0; y < chunk->height; y++) {
 			for (x = 0; x < chunk->width; x++) {
-				sqinfo_off(chunk->squares[y][x].info, SQUARE_WALL_INNER);
-				sqinfo_off(chunk->squares[y][x].info, SQUARE_WALL_OUTER);
-				sqinfo_off(chunk->squares[y][x].info, SQUARE_WALL_SOLID);
-				sqinfo_off(chunk->squares[y][x].info, SQUARE_MON_RESTRICT);
+				sqinfo_off(chunk->info[y][x], SQUARE_WALL_INNER);
+				sqinfo_off(chunk->info[y][x], SQUARE_WALL_OUTER);
+				sqinfo_off(chunk->info[y][x], SQUARE_WALL_SOLID);
+				sqinfo_off(chunk->info[y][x], SQUARE_MON_RESTRICT);
 			}
 		}
 
@@ -943,13 +946,10 @@ void cave_generate(struct chunk **c, struct player *p)
 			}
 			cave_clear(chunk, p);
 		}
-
-		mem_free(dun->cent);
-		mem_free(dun->door);
-		mem_free(dun->wall);
-		mem_free(dun->tunn);
 	}
 
+	mem_free(dun_locs);
+
 	if (error) quit_fmt("cave_generate() failed 100 times!");
 
 	/* Use the new cave */
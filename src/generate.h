@@ -258,9 +258,12 @@ struct chunk *gauntlet_gen(struct player *p);
 struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 						 bool objects, bool traps);
 void chunk_list_add(struct chunk *c);
-bool chunk_list_remove(char *name);
-struct chunk *chunk_find_name(char *name);
-bool chunk_find(struct chunk *c);
+bool chunk_list_remove(const char *name);
+void chunk_list_free(void);
+byte *chunk_list_encoding(const struct stored_chunk *s);
+bool chunk_find_name(const char *name);
+bool chunk_restore(struct chunk *dest, const char *name, int y0, int x0,
+				   int rotate, bool reflect);
 bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 				int rotate, bool reflect);
 
@@ -2839,6 +2839,7 @@ static struct init_module arrays_module = {
 
 
 extern struct init_module z_quark_module;
+extern struct init_module view_module;
 extern struct init_module generate_module;
 extern struct init_module rune_module;
 extern struct init_module obj_make_module;
@@ -2853,6 +2854,7 @@ static struct init_module *modules[] = {
 	&z_quark_module,
 	&messages_module,
 	&arrays_module,
+	&view_module,
 	&player_module,
 	&generate_module,
 	&rune_module,
@@ -2918,9 +2920,7 @@ void cleanup_angband(void)
 	event_remove_all_handlers();
 
 	/* Free the chunk list */
-	for (i = 0; i < chunk_list_max; i++)
-		cave_free(chunk_list[i]);
-	mem_free(chunk_list);
+	chunk_list_free();
 
 	/* Free the main cave */
 	if (cave) {
@@ -1208,7 +1208,7 @@ static int rd_dungeon_aux(struct chunk **c)
 	c1 = cave_new(height, width);
 	c1->name = string_make(name);
 
-    /* Run length decoding of cave->squares[y][x].info */
+    /* Run length decoding of cave->info[y][x] */
 	for (n = 0; n < square_size; n++) {
 		/* Load the dungeon data */
 		for (x = y = 0; y < c1->height; ) {
@@ -1219,7 +1219,7 @@ static int rd_dungeon_aux(struct chunk **c)
 			/* Apply the RLE info */
 			for (i = count; i > 0; i--) {
 				/* Extract "info" */
-				c1->squares[y][x].info[n] = tmp8u;
+				c1->info[y][x][n] = tmp8u;
 
 				/* Advance/Wrap */
 				if (++x >= c1->width) {
@@ -1276,10 +1276,6 @@ static int rd_objects_aux(rd_item_t rd_item_version, struct chunk *c)
 {
 	int i;
 
-	/* Only if the player's alive */
-	if (player->is_dead)
-		return 0;
-
 	/* Make the object list */
 	rd_u16b(&c->obj_max);
 	c->objects = mem_realloc(c->objects,
@@ -1294,7 +1290,7 @@ static int rd_objects_aux(rd_item_t rd_item_version, struct chunk *c)
 			break;
 
 		if (square_in_bounds_fully(c, obj->iy, obj->ix))
-			pile_insert_end(&c->squares[obj->iy][obj->ix].obj, obj);
+			pile_insert_end(&c->obj[obj->iy][obj->ix], obj);
 		assert(obj->oidx);
 		assert(c->objects[obj->oidx] == NULL);
 		c->objects[obj->oidx] = obj;
@@ -1311,10 +1307,6 @@ static int rd_monsters_aux(struct chunk *c)
 	int i;
 	u16b limit;
 
-	/* Only if the player's alive */
-	if (player->is_dead)
-		return 0;
-
 	/* Read the monster count */
 	rd_u16b(&limit);
 	if (limit > z_info->level_monster_max) {
@@ -1352,10 +1344,6 @@ static int rd_traps_aux(struct chunk *c)
 	int y, x;
 	struct trap *trap;
 
-    /* Only if the player's alive */
-    if (player->is_dead)
-		return 0;
-
     rd_byte(&trf_size);
 
 	/* Read traps until one has no location */
@@ -1368,8 +1356,8 @@ static int rd_traps_aux(struct chunk *c)
 			break;
 		else {
 			/* Put the trap at the front of the grid trap list */
-			trap->next = c->squares[y][x].trap;
-			c->squares[y][x].trap = trap;
+			trap->next = c->trap[y][x];
+			c->trap[y][x] = trap;
 		}
 	}
 
@@ -1431,6 +1419,10 @@ int rd_dungeon(void)
  */
 int rd_objects(void)
 {
+	/* Only if the player's alive */
+	if (player->is_dead)
+		return 0;
+
 	if (rd_objects_aux(rd_item, cave))
 		return -1;
 	if (rd_objects_aux(rd_item, player->cave))
@@ -1468,6 +1460,10 @@ int rd_monsters(void)
  */
 int rd_traps(void)
 {
+	/* Only if the player's alive */
+	if (player->is_dead)
+		return 0;
+
 	if (rd_traps_aux(cave))
 		return -1;
 	if (rd_traps_aux(player->cave))
@@ -1475,6 +1471,87 @@ int rd_traps(void)
 	return 0;
 }
 
+/**
+ * Read the objects, monsters and traps of a chunk
+ */
+static int rd_chunk_contents(struct chunk *c)
+{
+	/* Read the objects */
+	if (rd_objects_aux(rd_item, c))
+		return -1;
+
+	/* Read the monsters */
+	if (rd_monsters_aux(c))
+		return -1;
+
+	/* Read traps */
+	if (rd_traps_aux(c))
+		return -1;
+
+	return 0;
+}
+
+/**
+ * Sizes of things in the data being read, which come from the savefile
+ */
+struct rd_sizes {
+	byte square;
+	byte obj_mod;
+	byte of;
+	byte elem;
+	byte brand;
+	byte slay;
+	byte curse;
+	byte mflag;
+	byte trf;
+};
+
+static void rd_sizes_get(struct rd_sizes *sizes)
+{
+	sizes->square = square_size;
+	sizes->obj_mod = obj_mod_max;
+	sizes->of = of_size;
+	sizes->elem = elem_max;
+	sizes->brand = brand_max;
+	sizes->slay = slay_max;
+	sizes->curse = curse_max;
+	sizes->mflag = mflag_size;
+	sizes->trf = trf_size;
+}
+
+static void rd_sizes_set(const struct rd_sizes *sizes)
+{
+	square_size = sizes->square;
+	obj_mod_max = sizes->obj_mod;
+	of_size = sizes->of;
+	elem_max = sizes->elem;
+	brand_max = sizes->brand;
+	slay_max = sizes->slay;
+	curse_max = sizes->curse;
+	mflag_size = sizes->mflag;
+	trf_size = sizes->trf;
+}
+
+/**
+ * Read a chunk encoded by wr_chunk() for the chunk list.  That is always in
+ * this version's sizes, whatever savefile (if any) was loaded.
+ */
+int rd_chunk(struct chunk **c)
+{
+	struct rd_sizes file_sizes, own_sizes = {
+		SQUARE_SIZE, OBJ_MOD_MAX, OF_SIZE, ELEM_MAX, z_info->brand_max,
+		z_info->slay_max, z_info->curse_max, MFLAG_SIZE, TRF_SIZE
+	};
+	int err;
+
+	rd_sizes_get(&file_sizes);
+	rd_sizes_set(&own_sizes);
+	err = rd_dungeon_aux(c) ? -1 : rd_chunk_contents(*c);
+	rd_sizes_set(&file_sizes);
+
+	return err;
+}
+
 /**
  * Read the chunk list
  */
@@ -1483,8 +1560,8 @@ int rd_chunks(void)
 	int j;
 	u16b chunk_max;
 
-	//if (player->is_dead)
-	//	return 0;
+	/* Start from an empty list */
+	chunk_list_free();
 
 	rd_u16b(&chunk_max);
 	for (j = 0; j < chunk_max; j++) {
@@ -1494,17 +1571,11 @@ int rd_chunks(void)
 		if (rd_dungeon_aux(&c))
 			return -1;
 
-		/* Read the objects */
-		if (rd_objects_aux(rd_item, c))
-			return -1;
-
-		/* Read the monsters */
-		if (rd_monsters_aux(c))
-			return -1;
-
-		/* Read traps */
-		if (rd_traps_aux(c))
+		/* Read the rest, only if the player's alive */
+		if (!player->is_dead && rd_chunk_contents(c)) {
+			cave_free(c);
 			return -1;
+		}
 
 		chunk_list_add(c);
 	}
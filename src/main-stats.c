@@ -22,11 +22,13 @@
 
 #include "buildid.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "main.h"
 #include "mon-make.h"
 #include "monster.h"
 #include "obj-gear.h"
+#include "obj-pile.h"
 #include "obj-power.h"
 #include "obj-randart.h"
 #include "obj-tval.h"
@@ -42,6 +44,12 @@
 #include <stddef.h>
 #include <time.h>
 
+#ifdef HAVE_FORK
+# include <sys/types.h>
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
+
 #define OBJ_FEEL_MAX	 11
 #define MON_FEEL_MAX 	 10
 #define LEVEL_MAX 		101
@@ -65,6 +73,8 @@
 static int randarts = 0;
 static int no_selling = 0;
 static u32b num_runs = 1;
+static u32b num_workers = 1;
+static u32b seed_base;
 static bool quiet = false;
 static int nextkey = 0;
 static int running_stats = 0;
@@ -212,19 +222,35 @@ static void generate_player_for_stats()
 	player->history = get_history(player->race->history);
 }
 
-static void initialize_character(void)
+/**
+ * Start a run from a clean slate, so that it depends only on its seed and
+ * not on which runs came before it in this process
+ */
+static void initialize_character(u32b seed)
 {
-	u32b seed;
+	int i;
 
 	if (!quiet) {
 		printf(" [I  ]\b\b\b\b\b\b");
 		fflush(stdout);
 	}
 
-	seed = (time(NULL));
 	Rand_quick = false;
 	Rand_state_init(seed);
 
+	/* Forget the last run's levels before its monster counts are reset */
+	if (cave) {
+		wipe_mon_list(cave, player);
+		cave_free(cave);
+		cave = NULL;
+	}
+	if (player->cave) {
+		cave_free(player->cave);
+		player->cave = NULL;
+	}
+	chunk_list_free();
+	turn = 1;
+
 	player_init(player);
 	generate_player_for_stats();
 
@@ -235,6 +261,9 @@ static void initialize_character(void)
 		do_randart(seed_randart, false);
 	}
 
+	/* Stores choose new owners unlike the old ones, so forget those */
+	for (i = 0; i < MAX_STORES; i++)
+		stores[i].owner = NULL;
 	store_reset();
 	flavor_init();
 	player->upkeep->playing = true;
@@ -251,6 +280,13 @@ static void kill_all_monsters(int level)
 
 		level_data[level].monsters[mon->race->ridx]++;
 
+		/* Mimicked objects are not loot; take them off the floor first */
+		if (mon->mimicked_obj) {
+			square_excise_object(cave, mon->fy, mon->fx, mon->mimicked_obj);
+			delist_object(cave, mon->mimicked_obj);
+			object_delete(&mon->mimicked_obj);
+		}
+
 		monster_death(mon, true);
 
 		if (rf_has(mon->race->flags, RF_UNIQUE))
@@ -300,6 +336,9 @@ static void log_all_objects(int level)
 			for (obj = square_object(cave, y, x); obj; obj = obj->next) {
 				/*	u32b o_power = 0; */
 
+				/* Only the first ORIGIN_STATS origins are counted */
+				if (obj->origin >= ORIGIN_STATS) continue;
+
 /*				o_power = object_power(obj, false, NULL, true); */
 
 				/* Capture gold amounts */
@@ -784,7 +823,7 @@ static int stats_dump_lists(void)
 		err = stats_db_bind_ints(sql_stmt, 2, 0, idx, 
 			effects[idx].aim);
 		if (err) return err;
-		err = sqlite3_bind_text(sql_stmt, 2, effects[idx].desc,
+		err = sqlite3_bind_text(sql_stmt, 4, effects[idx].desc,
 			strlen(effects[idx].desc), SQLITE_STATIC);
 		if (err) return err;
 		STATS_DB_STEP_RESET(sql_stmt)
@@ -808,11 +847,11 @@ static int stats_dump_lists(void)
 	STATS_DB_FINALIZE(sql_stmt)
 
 	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO object_flags_list VALUES(?,?);");
+		"INSERT INTO object_flags_list(idx, name) VALUES(?,?);");
 	if (err) return err;
 
 	for (idx = 0; idx < OF_MAX; idx++) {
-		err = stats_db_bind_ints(sql_stmt, 1, idx);
+		err = stats_db_bind_ints(sql_stmt, 1, 0, idx);
 		if (err) return err;
 		err = sqlite3_bind_text(sql_stmt, 2, object_flag_names[idx],
 			strlen(object_flag_names[idx]), SQLITE_STATIC);
@@ -823,11 +862,11 @@ static int stats_dump_lists(void)
 	STATS_DB_FINALIZE(sql_stmt)
 
 	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO object_mods_list VALUES(?,?);");
+		"INSERT INTO object_mods_list(idx, name) VALUES(?,?);");
 	if (err) return err;
 
 	for (idx = 0; object_mods[idx] != NULL; idx++) {
-		err = stats_db_bind_ints(sql_stmt, 1, idx);
+		err = stats_db_bind_ints(sql_stmt, 1, 0, idx);
 		if (err) return err;
 		err = sqlite3_bind_text(sql_stmt, 2, object_mods[idx],
 			strlen(object_mods[idx]), SQLITE_STATIC);
@@ -887,6 +926,11 @@ static int stats_dump_info(void)
 	err = stats_db_exec(sql_buf);
 	if (err) return err;
 
+	strnfmt(sql_buf, 256, "INSERT INTO metadata VALUES('seed',%u);",
+		seed_base);
+	err = stats_db_exec(sql_buf);
+	if (err) return err;
+
 	err = stats_dump_artifacts();
 	if (err) return err;
 
@@ -1169,6 +1213,8 @@ static int stats_write_db_level_data(const char *table, int max_idx)
 			u32b count;
 			if (streq(table, "gold"))
 				count = *((long long *)((byte *)&level_data[level] + offset) + i);
+			else if (streq(table, "monsters"))
+				count = level_data[level].monsters[i];
 			else
 				count = *((u32b *)((byte *)&level_data[level] + offset) + i);
 
@@ -1455,12 +1501,282 @@ void progress_bar(u32b run, time_t start) {
 static void stats_cleanup_angband_run(void)
 {
 	if (player->history) mem_free(player->history);
+	player->history = NULL;
+}
+
+/**
+ * Make one run through the dungeon.  Runs are seeded by number, so the
+ * totals for a set of runs do not depend on which process made each one.
+ */
+static void stats_run(u32b run, const struct artifact *a_info_save)
+{
+	unsigned int i;
+
+	if (randarts)
+		for (i = 0; i < z_info->a_max; i++)
+			memcpy(&a_info[i], &a_info_save[i], sizeof(struct artifact));
+
+	initialize_character(seed_base + run);
+	unkill_uniques();
+	reset_artifacts();
+	descend_dungeon();
+	stats_cleanup_angband_run();
+}
+
+#ifdef HAVE_FORK
+
+/**
+ * A worker's results file, being written or merged back in.  Counts are
+ * mostly zero, so each nonzero one is stored with the number of zeros
+ * before it, and a zero value marks the end.
+ */
+struct stats_shard {
+	ang_file *f;
+	bool merge;
+	bool ok;
+	bool done;
+	u32b skip;
+	long long value;
+};
+
+static void stats_shard_path(char *buf, size_t len, u32b worker)
+{
+	char name[32];
+
+	strnfmt(name, sizeof(name), "worker-%u.tmp", worker);
+	path_build(buf, len, ANGBAND_DIR_STATS, name);
+}
+
+static void stats_shard_put(struct stats_shard *sh, long long value)
+{
+	if (!file_write(sh->f, (const char *) &sh->skip, sizeof(sh->skip)) ||
+		!file_write(sh->f, (const char *) &value, sizeof(value)))
+		sh->ok = false;
+	sh->skip = 0;
+}
+
+static void stats_shard_get(struct stats_shard *sh)
+{
+	if (file_read(sh->f, (char *) &sh->skip, sizeof(sh->skip)) !=
+		sizeof(sh->skip) ||
+		file_read(sh->f, (char *) &sh->value, sizeof(sh->value)) !=
+		sizeof(sh->value)) {
+		sh->ok = false;
+		sh->value = 0;
+	}
+	if (!sh->value) sh->done = true;
+}
+
+/**
+ * Write one count, or add the worker's count to it
+ */
+static void stats_shard_count(struct stats_shard *sh, long long *count)
+{
+	if (!sh->merge) {
+		if (*count)
+			stats_shard_put(sh, *count);
+		else
+			sh->skip++;
+	} else if (sh->skip) {
+		sh->skip--;
+	} else if (!sh->done) {
+		*count += sh->value;
+		stats_shard_get(sh);
+	} else {
+		/* The file ran out early */
+		sh->ok = false;
+	}
+}
+
+/**
+ * Write or merge a block of counts, passing over runs of zeros in bulk
+ */
+static void stats_shard_counts(struct stats_shard *sh, u32b *counts, size_t n)
+{
+	size_t i = 0;
+
+	while (i < n) {
+		long long count;
+
+		if (!sh->merge) {
+			while (i < n && !counts[i]) {
+				sh->skip++;
+				i++;
+			}
+		} else {
+			size_t zeros = MIN(sh->skip, n - i);
+
+			sh->skip -= zeros;
+			i += zeros;
+		}
+		if (i == n) break;
+
+		count = counts[i];
+		stats_shard_count(sh, &count);
+		counts[i++] = (u32b) count;
+	}
+}
+
+/**
+ * Pass over a block of n counts at once if it has nothing in it: when
+ * writing, if its total is zero, and when merging, if the worker said so
+ */
+static bool stats_shard_empty(struct stats_shard *sh, const u32b *total,
+							  size_t n)
+{
+	if (!sh->merge && !*total) {
+		sh->skip += n;
+		return true;
+	} else if (sh->merge && sh->skip >= n) {
+		sh->skip -= n;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * Go through every count in level_data in a fixed order
+ */
+static void stats_shard_level_data(struct stats_shard *sh)
+{
+	int level, origin, k, l;
+	size_t wearable_size = 1 + TOP_DICE * TOP_SIDES + TOP_AC + 2 * TOP_PLUS +
+		z_info->e_max + OF_MAX + TOP_MOD * (OBJ_MOD_MAX + 1);
+
+	for (level = 0; level < LEVEL_MAX; level++) {
+		struct level_data *ld = &level_data[level];
+
+		stats_shard_counts(sh, ld->monsters, z_info->r_max);
+		stats_shard_counts(sh, ld->obj_feelings, OBJ_FEEL_MAX);
+		stats_shard_counts(sh, ld->mon_feelings, MON_FEEL_MAX);
+
+		for (origin = 0; origin < ORIGIN_STATS; origin++) {
+			stats_shard_count(sh, &ld->gold[origin]);
+			stats_shard_counts(sh, ld->artifacts[origin], z_info->a_max);
+			stats_shard_counts(sh, ld->consumables[origin],
+							   consumable_count + 1);
+
+			for (k = 0; k < wearable_count + 1; k++) {
+				struct wearables_data *w = &ld->wearables[origin][k];
+
+				/* Most kinds are never found at a given level and origin */
+				if (stats_shard_empty(sh, &w->count, wearable_size))
+					continue;
+
+				stats_shard_counts(sh, &w->count, 1);
+				stats_shard_counts(sh, &w->dice[0][0], TOP_DICE * TOP_SIDES);
+				stats_shard_counts(sh, w->ac, TOP_AC);
+				stats_shard_counts(sh, w->hit, TOP_PLUS);
+				stats_shard_counts(sh, w->dam, TOP_PLUS);
+				stats_shard_counts(sh, w->egos, z_info->e_max);
+				stats_shard_counts(sh, w->flags, OF_MAX);
+				for (l = 0; l < TOP_MOD; l++)
+					stats_shard_counts(sh, w->modifiers[l], OBJ_MOD_MAX + 1);
+			}
+		}
+	}
 }
 
+static bool stats_shard_write(u32b worker)
+{
+	char path[1024];
+	struct stats_shard sh = { NULL, false, true, false, 0, 0 };
+
+	stats_shard_path(path, sizeof(path), worker);
+	sh.f = file_open(path, MODE_WRITE, FTYPE_RAW);
+	if (!sh.f) return false;
+
+	stats_shard_level_data(&sh);
+	stats_shard_put(&sh, 0);
+
+	if (!file_close(sh.f)) return false;
+	return sh.ok;
+}
+
+static bool stats_shard_merge(u32b worker)
+{
+	char path[1024];
+	struct stats_shard sh = { NULL, true, true, false, 0, 0 };
+
+	stats_shard_path(path, sizeof(path), worker);
+	sh.f = file_open(path, MODE_READ, FTYPE_RAW);
+	if (!sh.f) return false;
+
+	stats_shard_get(&sh);
+	stats_shard_level_data(&sh);
+
+	file_close(sh.f);
+	file_delete(path);
+	return sh.ok && sh.done && !sh.skip;
+}
+
+/**
+ * Share the runs out between forked workers, each counting into its own copy
+ * of level_data, then add the workers' counts into ours as they finish.
+ */
+static void stats_run_workers(const struct artifact *a_info_save, time_t start)
+{
+	pid_t *pids = mem_zalloc(num_workers * sizeof(pid_t));
+	u32b worker, finished = 0, done = 0;
+	bool ok = true;
+
+	/* Don't have the workers print what we've buffered */
+	fflush(stdout);
+
+	for (worker = 0; worker < num_workers; worker++) {
+		u32b first = (u32b) (((u64b) num_runs * worker) / num_workers) + 1;
+		u32b last = (u32b) (((u64b) num_runs * (worker + 1)) / num_workers);
+
+		pids[worker] = fork();
+		if (pids[worker] < 0) quit("Couldn't start a stats worker!");
+
+		if (!pids[worker]) {
+			u32b run;
+
+			quiet = true;
+			for (run = first; run <= last; run++)
+				stats_run(run, a_info_save);
+
+			/* Skip the parent's exit handlers and database */
+			_exit(stats_shard_write(worker) ? 0 : 1);
+		}
+	}
+
+	while (finished < num_workers) {
+		int status;
+		pid_t pid = wait(&status);
+
+		if (pid < 0) break;
+		for (worker = 0; worker < num_workers; worker++)
+			if (pids[worker] == pid) break;
+		if (worker == num_workers) continue;
+		finished++;
+
+		if (!WIFEXITED(status) || WEXITSTATUS(status) ||
+			!stats_shard_merge(worker)) {
+			ok = false;
+			continue;
+		}
+
+		done += (u32b) (((u64b) num_runs * (worker + 1)) / num_workers) -
+			(u32b) (((u64b) num_runs * worker) / num_workers);
+		if (!quiet) progress_bar(done, start);
+	}
+
+	mem_free(pids);
+	if (!ok || finished < num_workers) {
+		stats_db_close();
+		quit("A stats worker failed!");
+	}
+}
+
+#endif /* HAVE_FORK */
+
 static errr run_stats(void)
 {
 	u32b run;
-	struct artifact *a_info_save;
+	struct artifact *a_info_save = NULL;
 	unsigned int i;
 	int err;
 	bool status; 
@@ -1483,24 +1799,28 @@ static errr run_stats(void)
 	status = stats_prep_db();
 	if (!status) quit("Couldn't prepare database!");
 
+	if (num_workers > num_runs) num_workers = MAX(num_runs, 1);
+
 	if (!quiet) {
-		printf("Beginning %d runs...\n", num_runs);
+		if (num_workers > 1)
+			printf("Beginning %d runs in %d workers...\n", num_runs,
+				   num_workers);
+		else
+			printf("Beginning %d runs...\n", num_runs);
 		fflush(stdout);
 	}
 
 	start = time(NULL);
+#ifdef HAVE_FORK
+	if (num_workers > 1) {
+		if (!quiet) progress_bar(0, start);
+		stats_run_workers(a_info_save, start);
+	} else
+#endif /* HAVE_FORK */
 	for (run = 1; run <= num_runs; run++) {
 		if (!quiet) progress_bar(run - 1, start);
 
-		if (randarts)
-			for (i = 0; i < z_info->a_max; i++)
-				memcpy(&a_info[i], &a_info_save[i], sizeof(struct artifact));
-
-		initialize_character();
-		unkill_uniques();
-		reset_artifacts();
-		descend_dungeon();
-		stats_cleanup_angband_run();
+		stats_run(run, a_info_save);
 
 		/* Checkpoint every so many runs */
 		if (run % RUNS_PER_CHECKPOINT == 0) {
@@ -1524,7 +1844,7 @@ static errr run_stats(void)
 		fflush(stdout);
 	}
 
-	err = stats_write_db(run);
+	err = stats_write_db(num_runs);
 	stats_db_close();
 	if (err) quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
 
@@ -1659,22 +1979,27 @@ static void term_data_link(int i) {
 	angband_term[i] = t;
 }
 
-const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling)";
+const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling) -j(# of workers) -S(seed)";
 
 /**
  * Usage:
  *
- * angband -mstats -- [-q] [-r] [-nNNNN] [-s]
+ * angband -mstats -- [-q] [-r] [-nNNNN] [-s] [-jNN] [-SNNNN]
  *
  *   -q      Quiet mode (turn off progress messages)
  *   -r      Turn on randarts
  *   -nNNNN  Make NNNN runs through the dungeon (default: 1)
  *   -s      Turn on no-selling
+ *   -jNN    Share the runs between NN worker processes (default: 1)
+ *   -SNNNN  Seed run N with NNNN + N, for repeatable results (default: the
+ *           current time)
  */
 
 errr init_stats(int argc, char *argv[]) {
 	int i;
 
+	seed_base = (u32b) time(NULL);
+
 	/* Skip over argv[0] */
 	for (i = 1; i < argc; i++) {
 		if (streq(argv[i], "-r")) {
@@ -1693,6 +2018,18 @@ errr init_stats(int argc, char *argv[]) {
 			no_selling = 1;
 			continue;
 		}
+		if (prefix(argv[i], "-j")) {
+			num_workers = MAX(atoi(&argv[i][2]), 1);
+#ifndef HAVE_FORK
+			printf("init-stats: no worker processes on this system\n");
+			num_workers = 1;
+#endif
+			continue;
+		}
+		if (prefix(argv[i], "-S")) {
+			seed_base = strtoul(&argv[i][2], NULL, 10);
+			continue;
+		}
 		printf("init-stats: bad argument '%s'\n", argv[i]);
 	}
 
@@ -1664,6 +1664,7 @@ static void cleanup_monster(void)
 	}
 
 	mem_free(r_info);
+	reset_monster_lookups();
 }
 
 struct file_parser monster_parser = {
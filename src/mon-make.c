@@ -23,6 +23,7 @@
 #include "mon-desc.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-predicate.h"
 #include "mon-timed.h"
 #include "mon-util.h"
@@ -41,6 +42,33 @@ s16b num_repro;
 static s16b alloc_race_size;
 static struct alloc_entry *alloc_race_table;
 
+/**
+ * Cumulative allocation probabilities for one level.  Entry i is the total
+ * probability of the first i + 1 entries of alloc_race_table which
+ * get_mon_num() would accept at that level, so picking a monster is a
+ * binary search rather than a scan of the whole table.
+ */
+struct race_alloc_cache {
+	u32b stamp;		/* Value of alloc_race_stamp when built, 0 if never */
+	int size;		/* Number of table entries at or below the level */
+	long total;		/* Total probability */
+	long *cumul;	/* Cumulative probabilities */
+};
+
+/**
+ * Cached tables are indexed by level and rebuilt lazily when their stamp
+ * is out of date.  The stamp moves on whenever get_mon_num_prep() changes
+ * the restriction, a unique becomes available or unavailable, the player
+ * changes depth or the seasonal monsters come and go.
+ */
+static struct race_alloc_cache *alloc_race_cache;
+static u32b alloc_race_stamp;
+static int *alloc_race_uniques;
+static bool *alloc_race_unique_ok;
+static int alloc_race_unique_count;
+static bool alloc_race_season;
+static int alloc_race_depth;
+
 static void init_race_allocs(void) {
 	int i;
 	struct monster_race *race;
@@ -118,9 +146,30 @@ static void init_race_allocs(void) {
 	}
 	mem_free(aux);
 	mem_free(num);
+
+	/* Note the uniques, whose availability affects the cached tables */
+	alloc_race_uniques = mem_zalloc(alloc_race_size * sizeof(int));
+	alloc_race_unique_ok = mem_zalloc(alloc_race_size * sizeof(bool));
+	alloc_race_unique_count = 0;
+	for (i = 0; i < alloc_race_size; i++)
+		if (rf_has(r_info[table[i].index].flags, RF_UNIQUE))
+			alloc_race_uniques[alloc_race_unique_count++] = i;
+
+	/* Nothing is cached yet */
+	alloc_race_cache = mem_zalloc(z_info->max_depth *
+								  sizeof(struct race_alloc_cache));
+	alloc_race_stamp = 1;
+	alloc_race_depth = -1;
 }
 
 static void cleanup_race_allocs(void) {
+	int i;
+
+	for (i = 0; i < z_info->max_depth; i++)
+		mem_free(alloc_race_cache[i].cumul);
+	mem_free(alloc_race_cache);
+	mem_free(alloc_race_unique_ok);
+	mem_free(alloc_race_uniques);
 	mem_free(alloc_race_table);
 }
 
@@ -155,7 +204,7 @@ void delete_monster_idx(int m_idx)
 		health_track(player->upkeep, NULL);
 
 	/* Monster is gone */
-	cave->squares[y][x].mon = 0;
+	cave->mon[y][x] = 0;
 
 	/* Delete objects */
 	struct object *obj = mon->held_obj;
@@ -200,8 +249,8 @@ void delete_monster(int y, int x)
 	assert(square_in_bounds(cave, y, x));
 
 	/* Delete the monster (if any) */
-	if (cave->squares[y][x].mon > 0)
-		delete_monster_idx(cave->squares[y][x].mon);
+	if (cave->mon[y][x] > 0)
+		delete_monster_idx(cave->mon[y][x]);
 }
 
 
@@ -223,7 +272,7 @@ static void compact_monsters_aux(int i1, int i2)
 	x = mon->fx;
 
 	/* Update the cave */
-	cave->squares[y][x].mon = i2;
+	cave->mon[y][x] = i2;
 
 	/* Update midx */
 	mon->midx = i2;
@@ -251,6 +300,9 @@ static void compact_monsters_aux(int i1, int i2)
 
 	/* Hack -- wipe hole */
 	memset(cave_monster(cave, i1), 0, sizeof(struct monster));
+
+	/* Keep it on schedule */
+	monster_schedule_move(cave, i1, i2);
 }
 
 
@@ -376,7 +428,7 @@ void wipe_mon_list(struct chunk *c, struct player *p)
 		mon->race->cur_num--;
 
 		/* Monster is gone */
-		c->squares[mon->fy][mon->fx].mon = 0;
+		c->mon[mon->fy][mon->fx] = 0;
 
 		/* Wipe the Monster */
 		memset(mon, 0, sizeof(struct monster));
@@ -467,40 +519,141 @@ void get_mon_num_prep(bool (*get_mon_num_hook)(struct monster_race *race))
 		else
 			entry->prob2 = 0;
 	}
+
+	/* Cached tables are out of date */
+	alloc_race_stamp++;
 }
 
+
 /**
- * Helper function for get_mon_num(). Scans the prepared monster allocation
- * table and picks a random monster. Returns the index of a monster in
- * `table`.
+ * Check whether anything outside the allocation table which decides what
+ * get_mon_num() may pick has changed since the cached tables were built,
+ * and if so mark them all out of date.
  */
-static struct monster_race *get_mon_race_aux(long total,
-											 const alloc_entry *table)
+static void check_race_allocs(void)
 {
 	int i;
+	bool stale = false;
 
-	/* Pick a monster */
-	long value = randint0(total);
+	/* Check the date once, rather than for every seasonal monster */
+	time_t cur_time = time(NULL);
+	struct tm *date = localtime(&cur_time);
+	bool season = date->tm_mon == 11 && date->tm_mday >= 24 &&
+		date->tm_mday <= 26;
+
+	if (season != alloc_race_season) {
+		alloc_race_season = season;
+		stale = true;
+	}
+
+	/* Monsters which never appear out of depth depend on the player */
+	if (player->depth != alloc_race_depth) {
+		alloc_race_depth = player->depth;
+		stale = true;
+	}
+
+	/* Only one copy of a unique must be around at the same time */
+	for (i = 0; i < alloc_race_unique_count; i++) {
+		int index = alloc_race_table[alloc_race_uniques[i]].index;
+		struct monster_race *race = &r_info[index];
+		bool ok = race->cur_num < race->max_num;
+
+		if (ok != alloc_race_unique_ok[i]) {
+			alloc_race_unique_ok[i] = ok;
+			stale = true;
+		}
+	}
+
+	if (stale) alloc_race_stamp++;
+}
+
+
+/**
+ * Get the cumulative allocation table for a level, building it if needed.
+ */
+static const struct race_alloc_cache *get_race_allocs(int level)
+{
+	int i;
+	long total = 0L;
+	struct race_alloc_cache *cache = &alloc_race_cache[level];
 
-	/* Find the monster */
+	if (cache->stamp == alloc_race_stamp) return cache;
+
+	if (!cache->cumul)
+		cache->cumul = mem_zalloc(alloc_race_size * sizeof(long));
+
+	/* Process probabilities */
 	for (i = 0; i < alloc_race_size; i++) {
-		/* Found the entry */
-		if (value < table[i].prob3) break;
+		const alloc_entry *entry = &alloc_race_table[i];
+		struct monster_race *race = &r_info[entry->index];
+		bool accept = true;
+
+		/* Monsters are sorted by depth */
+		if (entry->level > level) break;
+
+		/* No town monsters in dungeon */
+		if ((level > 0) && (entry->level <= 0))
+			accept = false;
+
+		/* No seasonal monsters outside of Christmas */
+		else if (rf_has(race->flags, RF_SEASONAL) && !alloc_race_season)
+			accept = false;
+
+		/* Only one copy of a a unique must be around at the same time */
+		else if (rf_has(race->flags, RF_UNIQUE) &&
+				 race->cur_num >= race->max_num)
+			accept = false;
+
+		/* Some monsters never appear out of depth */
+		else if (rf_has(race->flags, RF_FORCE_DEPTH) &&
+				 race->level > alloc_race_depth)
+			accept = false;
+
+		/* Total */
+		if (accept) total += entry->prob2;
+		cache->cumul[i] = total;
+	}
+
+	cache->size = i;
+	cache->total = total;
+	cache->stamp = alloc_race_stamp;
+
+	return cache;
+}
+
+/**
+ * Helper function for get_mon_num(). Searches the cumulative allocation
+ * table for a level and picks a random monster.
+ */
+static struct monster_race *get_mon_race_aux(const struct race_alloc_cache
+											 *cache)
+{
+	int low = 0, high = cache->size - 1;
+
+	/* Pick a monster */
+	long value = randint0(cache->total);
 
-		/* Decrement */
-		value -= table[i].prob3;
+	/* Find the first entry whose cumulative probability exceeds the value */
+	while (low < high) {
+		int mid = (low + high) / 2;
+
+		if (cache->cumul[mid] > value)
+			high = mid;
+		else
+			low = mid + 1;
 	}
 
-	return &r_info[table[i].index];
+	return &r_info[alloc_race_table[low].index];
 }
 
 /**
  * Chooses a monster race that seems "appropriate" to the given level
  *
  * This function uses the "prob2" field of the "monster allocation table",
- * and various local information, to calculate the "prob3" field of the
- * same table, which is then used to choose an "appropriate" monster, in
- * a relatively efficient manner.
+ * and various local information, to build a cumulative probability table
+ * for the level, which is then used to choose an "appropriate" monster, in
+ * a relatively efficient manner.  The tables are kept between calls until
+ * something they depend on changes.
  *
  * Note that "town" monsters will *only* be created in the town, and
  * "normal" monsters will *never* be created in the town, unless the
@@ -518,63 +671,31 @@ static struct monster_race *get_mon_race_aux(long total,
  */
 struct monster_race *get_mon_num(int level)
 {
-	int i, p;
+	int p;
 
-	long total;
+	const struct race_alloc_cache *cache;
 
 	struct monster_race *race;
 
-	alloc_entry *table = alloc_race_table;
-
 	/* Occasionally produce a nastier monster in the dungeon */
 	if (level > 0 && one_in_(z_info->ood_monster_chance))
 		level += MIN(level / 4 + 2, z_info->ood_monster_amount);
 
-	total = 0L;
-
-	/* Process probabilities */
-	for (i = 0; i < alloc_race_size; i++) {
-		time_t cur_time = time(NULL);
-		struct tm *date = localtime(&cur_time);
-
-		/* Monsters are sorted by depth */
-		if (table[i].level > level) break;
-
-		/* Default */
-		table[i].prob3 = 0;
-
-		/* No town monsters in dungeon */
-		if ((level > 0) && (table[i].level <= 0)) continue;
-
-		/* Get the chosen monster */
-		race = &r_info[table[i].index];
-
-		/* No seasonal monsters outside of Christmas */
-		if (rf_has(race->flags, RF_SEASONAL) &&
-			!(date->tm_mon == 11 && date->tm_mday >= 24 && date->tm_mday <= 26))
-			continue;
-
-		/* Only one copy of a a unique must be around at the same time */
-		if (rf_has(race->flags, RF_UNIQUE) &&
-				race->cur_num >= race->max_num)
-			continue;
-
-		/* Some monsters never appear out of depth */
-		if (rf_has(race->flags, RF_FORCE_DEPTH) && race->level > player->depth)
-			continue;
+	/* Nothing lives above the town */
+	if (level < 0) return NULL;
 
-		/* Accept */
-		table[i].prob3 = table[i].prob2;
+	/* Every monster is eligible from the deepest level on */
+	if (level >= z_info->max_depth) level = z_info->max_depth - 1;
 
-		/* Total */
-		total += table[i].prob3;
-	}
+	/* Get the probabilities */
+	check_race_allocs();
+	cache = get_race_allocs(level);
 
 	/* No legal monsters */
-	if (total <= 0) return NULL;
+	if (cache->total <= 0) return NULL;
 
 	/* Pick a monster */
-	race = get_mon_race_aux(total, table);
+	race = get_mon_race_aux(cache);
 
 	/* Try for a "harder" monster once (50%) or twice (10%) */
 	p = randint0(100);
@@ -583,7 +704,7 @@ struct monster_race *get_mon_num(int level)
 		struct monster_race *old = race;
 
 		/* Pick a new monster */
-		race = get_mon_race_aux(total, table);
+		race = get_mon_race_aux(cache);
 
 		/* Keep the deepest one */
 		if (race->level < old->level) race = old;
@@ -594,7 +715,7 @@ struct monster_race *get_mon_num(int level)
 		struct monster_race *old = race;
 
 		/* Pick a monster */
-		race = get_mon_race_aux(total, table);
+		race = get_mon_race_aux(cache);
 
 		/* Keep the deepest one */
 		if (race->level < old->level) race = old;
@@ -691,7 +812,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 			}
 
 			/* Allocate by hand, prep, apply magic */
-			obj = mem_zalloc(sizeof(*obj));
+			obj = object_new();
 			object_prep(obj, kind, 100, RANDOMISE);
 			obj->artifact = art;
 			copy_artifact_data(obj, obj->artifact);
@@ -709,7 +830,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 			} else {
 				obj->artifact->created = false;
 				object_wipe(obj);
-				mem_free(obj);
+				object_free(obj);
 			}
 		}
 	}
@@ -720,7 +841,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 			continue;
 
 		/* Allocate by hand, prep, apply magic */
-		obj = mem_zalloc(sizeof(*obj));
+		obj = object_new();
 		object_prep(obj, drop->kind, level, RANDOMISE);
 		apply_magic(obj, level, true, good, great, extra_roll);
 
@@ -735,7 +856,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 			any = true;
 		} else {
 			object_wipe(obj);
-			mem_free(obj);
+			object_free(obj);
 		}
 	}
 
@@ -759,7 +880,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 		} else {
 			obj->artifact->created = false;
 			object_wipe(obj);
-			mem_free(obj);
+			object_free(obj);
 		}
 	}
 
@@ -803,11 +924,14 @@ s16b place_monster(struct chunk *c, int y, int x, struct monster *mon,
 	new_mon->midx = m_idx;
 
 	/* Set the location */
-	c->squares[y][x].mon = new_mon->midx;
+	c->mon[y][x] = new_mon->midx;
 	new_mon->fy = y;
 	new_mon->fx = x;
 	assert(square_monster(c, y, x) == new_mon);
 
+	/* Give it its first turn at the right time */
+	monster_reschedule(c, new_mon);
+
 	update_mon(new_mon, c, true);
 
 	/* Hack -- Count the number of "reproducers" */
@@ -1464,6 +1588,7 @@ bool mon_take_hit(struct monster *mon, int dam, bool *fear, const char *note)
 
 	/* Hurt it */
 	mon->hp -= dam;
+	monster_end_dormancy(cave, mon);
 
 	/* It is dead now */
 	if (mon->hp < 0) {
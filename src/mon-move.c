@@ -31,6 +31,7 @@
 #include "mon-desc.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-predicate.h"
 #include "mon-spell.h"
 #include "mon-util.h"
@@ -173,9 +174,9 @@ static bool near_permwall(const struct monster *mon, struct chunk *c)
  *
  * Note that ghosts and rock-eaters generally just head straight for the player.
  *
- * Monsters first try to use current sound information as saved in
- * cave->noise.grids[y][x].  Failing that, they'll try using scent, saved in 
- * cave->scent.grids[y][x].
+ * Monsters first try to use current sound information as given by
+ * cave_noise().  Failing that, they'll try using scent, as given by
+ * cave_scent().
  *
  * Tracking by 'scent' means that monsters end up near enough the player to
  * switch to 'sound' (noise), or they end up somewhere the player left via 
@@ -192,7 +193,7 @@ static bool get_moves_advance(struct chunk *c, struct monster *mon)
 	int my = mon->fy, mx = mon->fx;
 	int base_hearing = mon->race->hearing
 		- player->state.skills[SKILL_STEALTH] / 3;
-	int best_noise = base_hearing - cave->noise.grids[my][mx];
+	int best_noise = base_hearing - cave_noise(c, my, mx);
 	int best_direction = 8;
 
 	/* If the monster can pass through nearby walls, do that */
@@ -212,14 +213,15 @@ static bool get_moves_advance(struct chunk *c, struct monster *mon)
 		/* Get the location */
 		int y = my + ddy_ddd[i];
 		int x = mx + ddx_ddd[i];
-		int heard_noise, smelled_scent;
+		int noise, heard_noise, smelled_scent;
 
 		/* Bounds check */
 		if (!square_in_bounds(c, y, x)) continue;
 
 		/* Get the heard noise, compare with the best so far */
-		heard_noise = base_hearing - cave->noise.grids[y][x];
-		if ((heard_noise > best_noise) && (cave->noise.grids[y][x] != 0)) {
+		noise = cave_noise(c, y, x);
+		heard_noise = base_hearing - noise;
+		if ((heard_noise > best_noise) && (noise != 0)) {
 			best_noise = heard_noise;
 			best_direction = i;
 			found_direction = true;
@@ -228,8 +230,10 @@ static bool get_moves_advance(struct chunk *c, struct monster *mon)
 
 		/* If no good sound yet, use scent */
 		if (!best_noise) {
-			smelled_scent = mon->race->smell - cave->scent.grids[y][x];
-			if ((smelled_scent > best_scent) && (cave->scent.grids[y][x] != 0)){
+			int scent = cave_scent(c, y, x);
+
+			smelled_scent = mon->race->smell - scent;
+			if ((smelled_scent > best_scent) && (scent != 0)) {
 				best_scent = smelled_scent;
 				best_direction = i;
 				found_direction = true;
@@ -255,10 +259,11 @@ static bool monster_can_hear(struct chunk *c, struct monster *mon)
 {
 	int base_hearing = mon->race->hearing
 		- player->state.skills[SKILL_STEALTH] / 3;
-	if (cave->noise.grids[mon->fy][mon->fx] == 0) {
+	int noise = cave_noise_near(c, mon->fy, mon->fx, base_hearing - 1);
+	if (noise == 0) {
 		return false;
 	}
-	return base_hearing > cave->noise.grids[mon->fy][mon->fx];
+	return base_hearing > noise;
 }
 
 /**
@@ -266,10 +271,12 @@ static bool monster_can_hear(struct chunk *c, struct monster *mon)
  */
 static bool monster_can_smell(struct chunk *c, struct monster *mon)
 {
-	if (cave->scent.grids[mon->fy][mon->fx] == 0) {
+	int scent = cave_scent(c, mon->fy, mon->fx);
+
+	if (scent == 0) {
 		return false;
 	}
-	return mon->race->smell > cave->scent.grids[mon->fy][mon->fx];
+	return mon->race->smell > scent;
 }
 
 /**
@@ -314,7 +321,7 @@ static bool get_moves_fear(struct chunk *c, struct monster *mon)
 		 * First half of calculation is inversely proportional to distance
 		 * Second half is inversely proportional to grid's distance from player
 		 */
-		score = 5000 / (dis + 3) - 500 / (c->noise.grids[y][x] + 1);
+		score = 5000 / (dis + 3) - 500 / (cave_noise(c, y, x) + 1);
 
 		/* No negative scores */
 		if (score < 0) score = 0;
@@ -386,7 +393,7 @@ static bool find_safety(struct chunk *c, struct monster *mon)
 			if (!square_ispassable(c, y, x)) continue;
 
 			/* Ignore too-distant grids */
-			if (c->noise.grids[y][x] > c->noise.grids[fy][fx] + 2 * d)
+			if (cave_noise(c, y, x) > cave_noise(c, fy, fx) + 2 * d)
 				continue;
 
 			/* Ignore damaging terrain if they can't handle it */
@@ -744,7 +751,7 @@ static bool process_monster_multiply(struct chunk *c, struct monster *mon)
 	/* Count the adjacent monsters */
 	for (y = mon->fy - 1; y <= mon->fy + 1; y++)
 		for (x = mon->fx - 1; x <= mon->fx + 1; x++)
-			if (c->squares[y][x].mon > 0) k++;
+			if (c->mon[y][x] > 0) k++;
 
 	/* Multiply slower in crowded areas */
 	if ((k < 4) && (k == 0 || one_in_(k * z_info->repro_monster_rate))) {
@@ -1290,7 +1297,7 @@ static void monster_reduce_sleep(struct monster *mon)
 
 	} else if ((notice * notice * notice) <= player_noise) {
 		int sleep_reduction = 1;
-		int local_noise = cave->noise.grids[mon->fy][mon->fx];
+		int local_noise = cave_noise_near(cave, mon->fy, mon->fx, 49);
 
 		/* Wake up faster near the player */
 		//if (mon->cdis < 50) {
@@ -1395,12 +1402,413 @@ static void regen_monster(struct monster *mon)
 }
 
 
+/**
+ * ------------------------------------------------------------------------
+ * Monster scheduling
+ *
+ * Every monster is given energy on every game turn, but most game turns all a
+ * monster does is gain that energy.  Rather than visit each monster every turn,
+ * a monster's energy is brought up to date only when it is needed, and the
+ * monster is put in the set for the first turn on which it will have enough
+ * energy to move; process_monsters() then only looks at the monsters in the
+ * set for the current turn, still in the same order as before.  All monsters
+ * are looked at on regeneration turns.
+ *
+ * A monster's energy is what it had at the start of game turn energy_turn,
+ * before that turn's energy was given.  Looking at a monster early is harmless,
+ * it just gets its energy as before, so stale entries in the sets don't matter.
+ *
+ * Monsters which are passive and too far from the player to notice anything
+ * go dormant, and are not scheduled at all.  All they would do is use their
+ * energy whenever they had enough, so that is worked out in bulk when they are
+ * next needed.  They stay dormant until the player comes within range, or
+ * they are moved, hurt, or have their speed or energy changed.
+ * ------------------------------------------------------------------------ */
+/**
+ * Number of upcoming game turns with their own set; monsters slower than this
+ * are just looked at early.
+ */
+#define MON_SCHEDULE_TURNS 128
+
+/**
+ * Sets after the per-turn ones
+ */
+#define MON_SCHEDULE_NOW MON_SCHEDULE_TURNS
+#define MON_SCHEDULE_HANDLED (MON_SCHEDULE_TURNS + 1)
+#define MON_SCHEDULE_DORMANT (MON_SCHEDULE_TURNS + 2)
+#define MON_SCHEDULE_SETS (MON_SCHEDULE_TURNS + 3)
+
+static u64b *schedule_set(struct monster_schedule *s, int set)
+{
+	return s->sets + set * s->words;
+}
+
+static void schedule_on(struct monster_schedule *s, int set, int idx)
+{
+	schedule_set(s, set)[idx / 64] |= (u64b)1 << (idx % 64);
+}
+
+static void schedule_off(struct monster_schedule *s, int set, int idx)
+{
+	schedule_set(s, set)[idx / 64] &= ~((u64b)1 << (idx % 64));
+}
+
+static bool schedule_has(struct monster_schedule *s, int set, int idx)
+{
+	return (schedule_set(s, set)[idx / 64] >> (idx % 64)) & 1;
+}
+
+/**
+ * Find the highest monster index below `idx` in a set, or 0 if there is none
+ */
+static int schedule_prev(struct monster_schedule *s, int set, int idx)
+{
+	u64b *bits = schedule_set(s, set);
+	int word, bit;
+	u64b w;
+
+	if (idx <= 1) return 0;
+
+	/* Ignore indices at or above idx */
+	word = (idx - 1) / 64;
+	w = bits[word] & (~(u64b)0 >> (63 - (idx - 1) % 64));
+
+	while (!w) {
+		if (--word < 0) return 0;
+		w = bits[word];
+	}
+
+	for (bit = 63; !((w >> bit) & 1); bit--) ;
+	return word * 64 + bit;
+}
+
+/**
+ * Whether the current monster is being looked after by the scheduler
+ */
+static bool schedule_tracks(struct chunk *c, const struct monster *mon)
+{
+	return c->mon_schedule.sets && mon->midx > 0 &&
+		mon->midx < cave_monster_max(c) &&
+		cave_monster(c, mon->midx) == mon;
+}
+
+/**
+ * The energy a monster gains each game turn
+ */
+static int monster_turn_energy(const struct monster *mon)
+{
+	/* Calculate the net speed */
+	int mspeed = mon->mspeed;
+	if (mon->m_timed[MON_TMD_FAST])
+		mspeed += 10;
+	if (mon->m_timed[MON_TMD_SLOW])
+		mspeed -= 2;
+
+	return turn_energy(mspeed);
+}
+
+/**
+ * The first game turn a monster is still due to get energy for, as things
+ * stand; this turn, unless it has been handled or passed over already
+ */
+static s32b monster_energy_due(struct chunk *c, const struct monster *mon)
+{
+	struct monster_schedule *s = &c->mon_schedule;
+
+	if (mflag_has(mon->mflag, MFLAG_HANDLED))
+		return turn + 1;
+	if (s->turn == turn && mon->midx > s->pass)
+		return turn + 1;
+	return turn;
+}
+
+/**
+ * Whether a dormant monster with the given energy at the start of this turn
+ * would have been handled by now
+ */
+static bool dormant_handled(struct chunk *c, const struct monster *mon,
+							int energy)
+{
+	struct monster_schedule *s = &c->mon_schedule;
+
+	if (s->turn != turn) return false;
+	if (mon->midx > s->pass) return true;
+	if (energy >= s->early_least) return true;
+	return mon->midx > s->early_pass && energy >= s->early_min;
+}
+
+/**
+ * How far from the player a monster has to be before it can go dormant; the
+ * noise, scent and view it could notice, and the distance at which it can
+ * come through walls, all lie within this
+ */
+static int dormant_range(const struct monster *mon)
+{
+	int hearing = mon->race->hearing
+		- player->state.skills[SKILL_STEALTH] / 3;
+
+	return MAX(MAX(hearing, mon->race->hearing), z_info->max_sight);
+}
+
+static bool dormant_in_range(const struct monster *mon)
+{
+	int range = dormant_range(mon);
+
+	return ABS(mon->fy - player->py) <= range &&
+		ABS(mon->fx - player->px) <= range;
+}
+
+/**
+ * Put a monster in the set for the first game turn it could move on
+ */
+static void schedule_monster(struct chunk *c, struct monster *mon)
+{
+	struct monster_schedule *s = &c->mon_schedule;
+	int gain = monster_turn_energy(mon);
+	int wait = 0;
+	s32b when;
+
+	if (mon->energy < z_info->move_energy)
+		wait = gain > 0 ?
+			(z_info->move_energy - mon->energy + gain - 1) / gain :
+			MON_SCHEDULE_TURNS;
+	when = mon->energy_turn + MIN(wait, MON_SCHEDULE_TURNS - 2);
+
+	/* Monsters yet to be looked at this turn may need looking at now */
+	if (mon->energy_turn == turn && s->turn == turn &&
+		(when == turn || turn % 100 == 0))
+		schedule_on(s, MON_SCHEDULE_NOW, mon->midx);
+	else
+		schedule_on(s, when % MON_SCHEDULE_TURNS, mon->midx);
+}
+
+/**
+ * Start scheduling the monsters on a level, whose energy is all up to date
+ */
+static void schedule_init(struct chunk *c)
+{
+	struct monster_schedule *s = &c->mon_schedule;
+	int i;
+
+	s->words = (z_info->level_monster_max + 63) / 64;
+	s->sets = mem_zalloc(MON_SCHEDULE_SETS * s->words * sizeof(u64b));
+	s->turn = turn - 1;
+	s->pass = 0;
+	s->early_pass = 0;
+	s->early_min = INT_MAX;
+	s->early_least = INT_MAX;
+
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race) continue;
+		if (mflag_has(mon->mflag, MFLAG_HANDLED))
+			schedule_on(s, MON_SCHEDULE_HANDLED, i);
+		mon->energy_turn = monster_energy_due(c, mon);
+		schedule_monster(c, mon);
+	}
+}
+
+/**
+ * Make the set of monsters to look at this game turn
+ */
+static void schedule_turn(struct chunk *c)
+{
+	struct monster_schedule *s = &c->mon_schedule;
+	u64b *now;
+	int i, n;
+
+	if (!s->sets)
+		schedule_init(c);
+	if (s->turn == turn)
+		return;
+
+	/* Gather the monsters due on every turn since the set was last made */
+	now = schedule_set(s, MON_SCHEDULE_NOW);
+	n = MIN(turn - s->turn, MON_SCHEDULE_TURNS);
+	while (n--) {
+		u64b *due = schedule_set(s, (turn - n) % MON_SCHEDULE_TURNS);
+		for (i = 0; i < s->words; i++) {
+			now[i] |= due[i];
+			due[i] = 0;
+		}
+	}
+
+	/* Everyone regenerates, except dormant monsters which are unhurt */
+	if (turn % 100 == 0)
+		for (i = 1; i < cave_monster_max(c); i++)
+			if (!schedule_has(s, MON_SCHEDULE_DORMANT, i))
+				schedule_on(s, MON_SCHEDULE_NOW, i);
+
+	s->turn = turn;
+	s->pass = z_info->level_monster_max;
+	s->early_pass = 0;
+	s->early_min = INT_MAX;
+	s->early_least = INT_MAX;
+}
+
+/**
+ * Check whether the player has come within range of any dormant monsters
+ */
+static void schedule_check_dormant(struct chunk *c)
+{
+	struct monster_schedule *s = &c->mon_schedule;
+	int stealth = player->state.skills[SKILL_STEALTH];
+	int i;
+
+	if (s->player_y == player->py && s->player_x == player->px &&
+		s->player_stealth == stealth)
+		return;
+
+	s->player_y = player->py;
+	s->player_x = player->px;
+	s->player_stealth = stealth;
+
+	for (i = schedule_prev(s, MON_SCHEDULE_DORMANT, cave_monster_max(c));
+		 i >= 1; i = schedule_prev(s, MON_SCHEDULE_DORMANT, i)) {
+		struct monster *mon = cave_monster(c, i);
+		if (mon->race && dormant_in_range(mon))
+			monster_end_dormancy(c, mon);
+	}
+}
+
+/**
+ * Bring a monster's energy up to date
+ */
+void monster_energy_settle(struct chunk *c, struct monster *mon)
+{
+	struct monster_schedule *s = &c->mon_schedule;
+	int gain, move = z_info->move_energy;
+	s32b due;
+
+	if (!schedule_tracks(c, mon)) return;
+	gain = monster_turn_energy(mon);
+
+	if (!schedule_has(s, MON_SCHEDULE_DORMANT, mon->midx)) {
+		due = monster_energy_due(c, mon);
+		if (mon->energy_turn < due) {
+			mon->energy += (due - mon->energy_turn) * gain;
+			mon->energy_turn = due;
+		}
+		return;
+	}
+
+	/* Dormant monsters use up their energy whenever they can */
+	while (mon->energy_turn < turn) {
+		int wait = turn - mon->energy_turn;
+
+		if (mon->energy >= move) {
+			mon->energy += gain - move;
+			mon->energy_turn++;
+			continue;
+		}
+
+		if (gain > 0)
+			wait = MIN(wait, (move - mon->energy + gain - 1) / gain);
+		mon->energy += wait * gain;
+		mon->energy_turn += wait;
+	}
+
+	/* Including this turn, if they would have been handled already */
+	if (mon->energy_turn == turn && !mflag_has(mon->mflag, MFLAG_HANDLED) &&
+		dormant_handled(c, mon, mon->energy)) {
+		bool moving = mon->energy >= move;
+
+		mflag_on(mon->mflag, MFLAG_HANDLED);
+		schedule_on(s, MON_SCHEDULE_HANDLED, mon->midx);
+		mon->energy += gain;
+		if (moving)
+			mon->energy -= move;
+		mon->energy_turn = turn + 1;
+	}
+}
+
+/**
+ * Put a dormant monster back on the schedule
+ */
+void monster_end_dormancy(struct chunk *c, struct monster *mon)
+{
+	if (!schedule_tracks(c, mon)) return;
+	if (!schedule_has(&c->mon_schedule, MON_SCHEDULE_DORMANT, mon->midx))
+		return;
+
+	monster_energy_settle(c, mon);
+	schedule_off(&c->mon_schedule, MON_SCHEDULE_DORMANT, mon->midx);
+	monster_reschedule(c, mon);
+}
+
+/**
+ * Reschedule a monster whose energy is up to date, after its energy or speed
+ * has been changed
+ */
+void monster_reschedule(struct chunk *c, struct monster *mon)
+{
+	if (!schedule_tracks(c, mon)) return;
+
+	schedule_off(&c->mon_schedule, MON_SCHEDULE_DORMANT, mon->midx);
+	mon->energy_turn = monster_energy_due(c, mon);
+	schedule_monster(c, mon);
+}
+
+/**
+ * Keep the schedule right when a monster is moved from index i1 to i2
+ */
+void monster_schedule_move(struct chunk *c, int i1, int i2)
+{
+	struct monster_schedule *s = &c->mon_schedule;
+	int set;
+
+	if (!s->sets) return;
+
+	for (set = MON_SCHEDULE_NOW; set < MON_SCHEDULE_SETS; set++) {
+		if (schedule_has(s, set, i1))
+			schedule_on(s, set, i2);
+		else
+			schedule_off(s, set, i2);
+		schedule_off(s, set, i1);
+	}
+	monster_energy_settle(c, cave_monster(c, i2));
+	if (!schedule_has(s, MON_SCHEDULE_DORMANT, i2))
+		schedule_monster(c, cave_monster(c, i2));
+}
+
+/**
+ * Return the first game turn, from the current one on, on which
+ * process_monsters() may have something to do
+ */
+s32b monsters_next_turn(struct chunk *c)
+{
+	struct monster_schedule *s = &c->mon_schedule;
+	s32b t;
+	int i;
+
+	if (!s->sets) return turn;
+
+	for (t = s->turn; ; t++) {
+		u64b *set = schedule_set(s, t == s->turn ? MON_SCHEDULE_NOW :
+								 t % MON_SCHEDULE_TURNS);
+
+		/* Everyone regenerates every hundred turns */
+		if (t >= turn && t % 100 == 0) return t;
+
+		/* Past the sets, so nothing is known */
+		if (t - s->turn > MON_SCHEDULE_TURNS) break;
+
+		/* Monsters left over this turn, or due then */
+		for (i = 0; i < s->words; i++)
+			if (set[i]) return MAX(t, turn);
+	}
+
+	return MAX(t, turn);
+}
+
 /**
  * Process all the "live" monsters, once per game turn.
  *
  * During each game turn, we scan through the list of all the "live" monsters,
  * (backwards, so we can excise any "freshly dead" monsters), energizing each
  * monster, and allowing fully energized monsters to move, attack, pass, etc.
+ * Only the monsters scheduled for this turn are actually visited; the rest
+ * get their energy when it is next needed.
  *
  * This function and its children are responsible for a considerable fraction
  * of the processor time in normal situations, greater if the character is
@@ -1408,8 +1816,8 @@ static void regen_monster(struct monster *mon)
  */
 void process_monsters(struct chunk *c, int minimum_energy)
 {
+	struct monster_schedule *s = &c->mon_schedule;
 	int i;
-	int mspeed;
 
 	/* Only process some things every so often */
 	bool regen = false;
@@ -1418,23 +1826,44 @@ void process_monsters(struct chunk *c, int minimum_energy)
 	if (turn % 100 == 0)
 		regen = true;
 
+	/* Find the monsters to look at */
+	schedule_turn(c);
+	schedule_check_dormant(c);
+	if (minimum_energy) {
+		s->early_pass = z_info->level_monster_max;
+		s->early_min = minimum_energy;
+	}
+
 	/* Process the monsters (backwards) */
-	for (i = cave_monster_max(c) - 1; i >= 1; i--) {
+	for (i = schedule_prev(s, MON_SCHEDULE_NOW, cave_monster_max(c)); i >= 1;
+		 i = schedule_prev(s, MON_SCHEDULE_NOW, i)) {
 		struct monster *mon;
 		bool moving;
 
 		/* Handle "leaving" */
 		if (player->is_dead || player->upkeep->generate_level) break;
 
-		/* Get a 'live' monster */
+		/* Monsters above this one have all had this pass */
+		if (minimum_energy)
+			s->early_pass = i;
+		else
+			s->pass = i;
+
+		/* Get a 'live' monster which is not dormant */
 		mon = cave_monster(c, i);
-		if (!mon->race) continue;
+		if (!mon->race || schedule_has(s, MON_SCHEDULE_DORMANT, i)) {
+			schedule_off(s, MON_SCHEDULE_NOW, i);
+			continue;
+		}
 
 		/* Ignore monsters that have already been handled */
-		if (mflag_has(mon->mflag, MFLAG_HANDLED))
+		if (mflag_has(mon->mflag, MFLAG_HANDLED)) {
+			schedule_off(s, MON_SCHEDULE_NOW, i);
 			continue;
+		}
 
 		/* Not enough energy to move yet */
+		monster_energy_settle(c, mon);
 		if (mon->energy < minimum_energy) continue;
 
 		/* Does this monster have enough energy to move? */
@@ -1442,28 +1871,28 @@ void process_monsters(struct chunk *c, int minimum_energy)
 
 		/* Prevent reprocessing */
 		mflag_on(mon->mflag, MFLAG_HANDLED);
+		schedule_on(s, MON_SCHEDULE_HANDLED, i);
+		schedule_off(s, MON_SCHEDULE_NOW, i);
 
 		/* Handle monster regeneration if requested */
 		if (regen)
 			regen_monster(mon);
 
-		/* Calculate the net speed */
-		mspeed = mon->mspeed;
-		if (mon->m_timed[MON_TMD_FAST])
-			mspeed += 10;
-		if (mon->m_timed[MON_TMD_SLOW])
-			mspeed -= 2;
-
 		/* Give this monster some energy */
-		mon->energy += turn_energy(mspeed);
+		mon->energy += monster_turn_energy(mon);
+		mon->energy_turn = turn + 1;
+
+		/* Use up "some" energy */
+		if (moving)
+			mon->energy -= z_info->move_energy;
+
+		/* Wait until the monster can next move */
+		schedule_monster(c, mon);
 
 		/* End the turn of monsters without enough energy to move */
 		if (!moving)
 			continue;
 
-		/* Use up "some" energy */
-		mon->energy -= z_info->move_energy;
-
 		/* Mimics lie in wait */
 		if (monster_is_mimicking(mon)) continue;
 
@@ -1481,9 +1910,36 @@ void process_monsters(struct chunk *c, int minimum_energy)
 
 			/* Monster is no longer current */
 			c->mon_current = -1;
+
+			/* The player may have moved */
+			schedule_check_dormant(c);
+		} else if (!dormant_in_range(mon)) {
+			/* Far from the player, so nothing will change for a while */
+			schedule_on(s, MON_SCHEDULE_DORMANT, i);
+		}
+	}
+
+	/* Monsters not reached when leaving miss this turn */
+	if (player->is_dead || player->upkeep->generate_level) {
+		for (i = 1; i < cave_monster_max(c); i++) {
+			struct monster *mon = cave_monster(c, i);
+			if (!mon->race) continue;
+			monster_energy_settle(c, mon);
+			if (mon->energy_turn == turn)
+				mon->energy_turn = turn + 1;
 		}
 	}
 
+	/* The pass is over */
+	if (minimum_energy) {
+		if (!player->is_dead && !player->upkeep->generate_level)
+			s->early_least = MIN(s->early_least, minimum_energy);
+		s->early_pass = 0;
+		s->early_min = INT_MAX;
+	} else {
+		s->pass = 0;
+	}
+
 	/* Update monster visibility after this */
 	/* XXX This may not be necessary */
 	player->upkeep->update |= PU_MONSTERS;
@@ -1496,15 +1952,20 @@ void process_monsters(struct chunk *c, int minimum_energy)
  */
 void reset_monsters(void)
 {
+	struct monster_schedule *s = &cave->mon_schedule;
 	int i;
 	struct monster *mon;
 
-	/* Process the monsters (backwards) */
-	for (i = cave_monster_max(cave) - 1; i >= 1; i--) {
+	if (!s->sets) return;
+
+	/* Process the monsters that were handled (backwards) */
+	for (i = schedule_prev(s, MON_SCHEDULE_HANDLED, cave_monster_max(cave));
+		 i >= 1; i = schedule_prev(s, MON_SCHEDULE_HANDLED, i)) {
 		/* Access the monster */
 		mon = cave_monster(cave, i);
 
 		/* Monster is ready to go again */
 		mflag_off(mon->mflag, MFLAG_HANDLED);
+		schedule_off(s, MON_SCHEDULE_HANDLED, i);
 	}
 }
@@ -20,6 +20,11 @@
 
 
 bool multiply_monster(const struct monster *m);
+void monster_energy_settle(struct chunk *c, struct monster *mon);
+void monster_end_dormancy(struct chunk *c, struct monster *mon);
+void monster_reschedule(struct chunk *c, struct monster *mon);
+void monster_schedule_move(struct chunk *c, int i1, int i2);
+s32b monsters_next_turn(struct chunk *c);
 void process_monsters(struct chunk *c, int minimum_energy);
 void reset_monsters(void);
 
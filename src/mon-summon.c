@@ -18,6 +18,7 @@
 
 #include "angband.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-summon.h"
 #include "mon-util.h"
 
@@ -188,6 +189,7 @@ int call_monster(int y, int x)
 
 	/* Set it's energy to 0 */
 	mon->energy = 0;
+	monster_reschedule(cave, mon);
 
 	return (mon->race->level);
 }
@@ -277,6 +279,7 @@ int summon_specific(int y1, int x1, int lev, int type, bool delay, bool call)
 	/* XXX should this now be hold monster for a turn? */
 	if (delay) {
 		mon->energy = 0;
+		monster_reschedule(cave, mon);
 		if (mon->race->speed > player->state.speed)
 			mon_inc_timed(mon, MON_TMD_SLOW, 1,
 				MON_TMD_FLG_NOMESSAGE, false);
@@ -19,6 +19,7 @@
 #include "angband.h"
 #include "mon-desc.h"
 #include "mon-lore.h"
+#include "mon-move.h"
 #include "mon-msg.h"
 #include "mon-predicate.h"
 #include "mon-spell.h"
@@ -183,7 +184,15 @@ static bool mon_set_timed(struct monster *mon,
 		resisted = true;
 		m_note = MON_MSG_UNAFFECTED;
 	} else {
+		/* Speed changes take effect from now on */
+		bool speed = effect_type == MON_TMD_FAST ||
+			effect_type == MON_TMD_SLOW;
+
+		if (speed)
+			monster_energy_settle(cave, mon);
 		mon->m_timed[effect_type] = timer;
+		if (speed)
+			monster_reschedule(cave, mon);
 
 		if (player->upkeep->health_who == mon)
 			player->upkeep->redraw |= (PR_HEALTH);
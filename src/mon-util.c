@@ -22,6 +22,7 @@
 #include "mon-list.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-msg.h"
 #include "mon-predicate.h"
 #include "mon-spell.h"
@@ -36,6 +37,7 @@
 #include "player-timed.h"
 #include "player-util.h"
 #include "project.h"
+#include "z-lookup.h"
 #include "z-set.h"
 
 static const struct monster_flag monster_flag_table[] =
@@ -94,6 +96,44 @@ void create_mon_flag_mask(bitflag *f, ...)
 }
 
 
+/**
+ * Monster race names, hashed ignoring case, so that lookup_monster() can
+ * find exact matches directly and substrings through the index of their
+ * three-letter runs.  Built on first use, rebuilt if r_info is reallocated or
+ * resized and thrown away by reset_monster_lookups().
+ */
+static struct name_index *race_names;
+static const struct monster_race *race_names_info;
+static int race_names_info_size;
+
+static void index_monsters(void)
+{
+	int i;
+
+	if (race_names && race_names_info == r_info &&
+		race_names_info_size == z_info->r_max)
+		return;
+
+	reset_monster_lookups();
+	race_names = name_index_new(true);
+	race_names_info = r_info;
+	race_names_info_size = z_info->r_max;
+	for (i = 0; i < z_info->r_max; i++)
+		if (r_info[i].name)
+			name_index_add(race_names, 0, r_info[i].name, i);
+}
+
+/**
+ * Throw away the monster name index, for when monster races are freed
+ */
+void reset_monster_lookups(void)
+{
+	name_index_free(race_names);
+	race_names = NULL;
+	race_names_info = NULL;
+	race_names_info_size = 0;
+}
+
 /**
  * Returns the monster with the given name. If no monster has the exact name
  * given, returns the first monster with the given name as a (case-insensitive)
@@ -101,26 +141,18 @@ void create_mon_flag_mask(bitflag *f, ...)
  */
 struct monster_race *lookup_monster(const char *name)
 {
-	int i;
-	struct monster_race *closest = NULL;
-	
-	/* Look for it */
-	for (i = 0; i < z_info->r_max; i++) {
-		struct monster_race *race = &r_info[i];
-		if (!race->name)
-			continue;
-
-		/* Test for equality */
-		if (my_stricmp(name, race->name) == 0)
-			return race;
-
-		/* Test for close matches */
-		if (!closest && my_stristr(race->name, name))
-			closest = race;
-	} 
-
-	/* Return our best match */
-	return closest;
+	int r_idx;
+
+	/* Look for an exact match */
+	index_monsters();
+	r_idx = name_index_find(race_names, 0, name);
+
+	/* Test for close matches */
+	if (r_idx < 0)
+		r_idx = name_index_find_part(race_names, name);
+
+	/* Return the match, if any */
+	return r_idx >= 0 ? &r_info[r_idx] : NULL;
 }
 
 /**
@@ -178,7 +210,7 @@ static void path_analyse(struct chunk *c, int y, int x)
 
 		/* Forget grids which would block los */
 		if (square_iswall(c, ny, nx)) {
-			sqinfo_off(c->squares[ny][nx].info, SQUARE_SEEN);
+			sqinfo_off(c->info[ny][nx], SQUARE_SEEN);
 			square_forget(c, ny, nx);
 			square_light_spot(c, ny, nx);
 		}
@@ -512,12 +544,12 @@ void monster_swap(int y1, int x1, int y2, int x2)
 	struct monster *mon;
 
 	/* Monsters */
-	m1 = cave->squares[y1][x1].mon;
-	m2 = cave->squares[y2][x2].mon;
+	m1 = cave->mon[y1][x1];
+	m2 = cave->mon[y2][x2];
 
 	/* Update grids */
-	cave->squares[y1][x1].mon = m2;
-	cave->squares[y2][x2].mon = m1;
+	cave->mon[y1][x1] = m2;
+	cave->mon[y2][x2] = m1;
 
 	/* Monster 1 */
 	if (m1 > 0) {
@@ -525,6 +557,7 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		mon = cave_monster(cave, m1);
 		mon->fy = y2;
 		mon->fx = x2;
+		monster_end_dormancy(cave, mon);
 
 		/* Update monster */
 		update_mon(mon, cave, true);
@@ -556,6 +589,7 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		mon = cave_monster(cave, m2);
 		mon->fy = y1;
 		mon->fx = x1;
+		monster_end_dormancy(cave, mon);
 
 		/* Update monster */
 		update_mon(mon, cave, true);
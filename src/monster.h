@@ -334,6 +334,7 @@ struct monster {
 
 	byte mspeed;		/* Monster "speed" */
 	byte energy;		/* Monster "energy" */
+	s32b energy_turn;	/* Game turn from which energy is still to be given */
 
 	byte cdis;			/* Current dis from player */
 
@@ -925,7 +925,7 @@ static enum parser_error parse_curse_name(struct parser *p) {
 	struct curse *h = parser_priv(p);
 
 	struct curse *curse = mem_zalloc(sizeof *curse);
-	curse->obj = mem_zalloc(sizeof(struct object));
+	curse->obj = object_new();
 	curse->next = h;
 	parser_setpriv(p, curse);
 	curse->name = string_make(name);
@@ -1221,11 +1221,11 @@ static void cleanup_curse(void)
 			if (curses[idx].obj->known) {
 				free_effect(curses[idx].obj->known->effect);
 				mem_free(curses[idx].obj->known->effect_msg);
-				mem_free(curses[idx].obj->known);
+				object_free(curses[idx].obj->known);
 			}
 			free_effect(curses[idx].obj->effect);
 			mem_free(curses[idx].obj->effect_msg);
-			mem_free(curses[idx].obj);
+			object_free(curses[idx].obj);
 		}
 		mem_free(curses[idx].poss);
 	}
@@ -1937,6 +1937,7 @@ static void cleanup_object(void)
 		free_effect(kind->effect);
 	}
 	mem_free(k_info);
+	reset_object_lookups();
 }
 
 struct file_parser object_parser = {
@@ -2384,6 +2385,7 @@ static void cleanup_ego(void)
 		}
 	}
 	mem_free(e_info);
+	reset_object_lookups();
 }
 
 struct file_parser ego_parser = {
@@ -2747,6 +2749,7 @@ static void cleanup_artifact(void)
 		mem_free(art->curses);
 	}
 	mem_free(a_info);
+	reset_object_lookups();
 }
 
 struct file_parser artifact_parser = {
@@ -829,7 +829,7 @@ void object_sense(struct player *p, struct object *obj)
 		/* Attach it to the current floor pile */
 		new_obj->iy = y;
 		new_obj->ix = x;
-		pile_insert_end(&p->cave->squares[y][x].obj, new_obj);
+		pile_insert_end(&p->cave->obj[y][x], new_obj);
 	}
 }
 
@@ -865,7 +865,7 @@ void object_see(struct player *p, struct object *obj)
 		new_obj->ix = x;
 		new_obj->number = obj->number;
 		if (!square_holds_object(p->cave, y, x, new_obj)) {
-			pile_insert_end(&p->cave->squares[y][x].obj, new_obj);
+			pile_insert_end(&p->cave->obj[y][x], new_obj);
 		}
 	} else if (known_obj->kind != obj->kind) {
 		int iy = known_obj->iy;
@@ -887,7 +887,7 @@ void object_see(struct player *p, struct object *obj)
 		known_obj->ix = x;
 		known_obj->held_m_idx = 0;
 		if (!square_holds_object(p->cave, y, x, known_obj)) {
-			pile_insert_end(&p->cave->squares[y][x].obj, known_obj);
+			pile_insert_end(&p->cave->obj[y][x], known_obj);
 		}
 	} else if (!square_holds_object(p->cave, y, x, known_obj)) {
 		int iy = known_obj->iy;
@@ -906,7 +906,7 @@ void object_see(struct player *p, struct object *obj)
 		known_obj->iy = y;
 		known_obj->ix = x;
 		known_obj->held_m_idx = 0;
-		pile_insert_end(&p->cave->squares[y][x].obj, known_obj);
+		pile_insert_end(&p->cave->obj[y][x], known_obj);
 	}
 }
 
@@ -31,12 +31,24 @@
 #include "obj-tval.h"
 #include "obj-util.h"
 
-/** Arrays holding an index of objects to generate for a given level */
-static u32b *obj_total;
-static byte *obj_alloc;
+/**
+ * Arrays holding cumulative allocation probabilities for each level; entry
+ * (lev * k_max + item) is the total probability of kinds 0 to item at that
+ * level, so the last entry of a level's row is the total for the level
+ */
+static u32b *obj_alloc;
+static u32b *obj_alloc_great;
 
-static u32b *obj_total_great;
-static byte *obj_alloc_great;
+/**
+ * The same for the kinds of each tval on their own.  The kinds of a tval
+ * are listed in index order in obj_tval_kinds from obj_tval_start[tval] up
+ * to obj_tval_start[tval + 1], and each level's row of obj_tval_alloc
+ * holds their cumulative probabilities at the same positions.
+ */
+static int *obj_tval_start;
+static int *obj_tval_kinds;
+static u32b *obj_tval_alloc;
+static u32b *obj_tval_alloc_great;
 
 static s16b alloc_ego_size = 0;
 static alloc_entry *alloc_ego_table;
@@ -53,38 +65,69 @@ static int num_money_types;
  * Initialize object allocation info
  */
 static void alloc_init_objects(void) {
-	int item, lev;
+	int item, lev, tval;
 	int k_max = z_info->k_max;
+	int levels = z_info->max_obj_depth + 1;
+	int *pos;
 
 	/* Allocate and wipe */
-	obj_alloc = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(byte));
-	obj_alloc_great = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(byte));
-	obj_total = mem_zalloc((z_info->max_obj_depth + 1) * sizeof(u32b));
-	obj_total_great = mem_zalloc((z_info->max_obj_depth + 1) * sizeof(u32b));
-
-	/* Init allocation data */
+	obj_alloc = mem_zalloc(levels * k_max * sizeof(u32b));
+	obj_alloc_great = mem_zalloc(levels * k_max * sizeof(u32b));
+	obj_tval_start = mem_zalloc((TV_MAX + 1) * sizeof(int));
+	obj_tval_kinds = mem_zalloc(k_max * sizeof(int));
+	obj_tval_alloc = mem_zalloc(levels * k_max * sizeof(u32b));
+	obj_tval_alloc_great = mem_zalloc(levels * k_max * sizeof(u32b));
+
+	/* Group the kinds by tval */
+	for (item = 0; item < k_max; item++)
+		obj_tval_start[k_info[item].tval + 1]++;
+	for (tval = 0; tval < TV_MAX; tval++)
+		obj_tval_start[tval + 1] += obj_tval_start[tval];
+	pos = mem_zalloc(TV_MAX * sizeof(int));
 	for (item = 0; item < k_max; item++) {
-		const struct object_kind *kind = &k_info[item];
-
-		int min = kind->alloc_min;
-		int max = kind->alloc_max;
-
-		/* If an item doesn't have a rarity, move on */
-		if (!kind->alloc_prob) continue;
-
-		/* Go through all the dungeon levels */
-		for (lev = 0; lev <= z_info->max_obj_depth; lev++) {
+		tval = k_info[item].tval;
+		obj_tval_kinds[obj_tval_start[tval] + pos[tval]++] = item;
+	}
+	mem_free(pos);
+
+	/* Go through all the dungeon levels */
+	for (lev = 0; lev < levels; lev++) {
+		u32b *row = obj_alloc + lev * k_max;
+		u32b *row_great = obj_alloc_great + lev * k_max;
+		u32b *tval_row = obj_tval_alloc + lev * k_max;
+		u32b *tval_row_great = obj_tval_alloc_great + lev * k_max;
+		u32b total = 0, total_great = 0;
+
+		/* Init allocation data */
+		for (item = 0; item < k_max; item++) {
+			const struct object_kind *kind = &k_info[item];
 			int rarity = kind->alloc_prob;
 
 			/* Save the probability in the standard table */
-			if ((lev < min) || (lev > max)) rarity = 0;
-			obj_total[lev] += rarity;
-			obj_alloc[(lev * k_max) + item] = rarity;
+			if ((lev < kind->alloc_min) || (lev > kind->alloc_max))
+				rarity = 0;
+			total += rarity;
+			row[item] = total;
 
 			/* Save the probability in the "great" table if relevant */
-			if (!kind_is_good(kind)) rarity = 0;
-			obj_total_great[lev] += rarity;
-			obj_alloc_great[(lev * k_max) + item] = rarity;
+			if (rarity && !kind_is_good(kind)) rarity = 0;
+			total_great += rarity;
+			row_great[item] = total_great;
+		}
+
+		/* Accumulate again within each tval */
+		for (tval = 0; tval < TV_MAX; tval++) {
+			int i;
+
+			total = total_great = 0;
+			for (i = obj_tval_start[tval]; i < obj_tval_start[tval + 1]; i++) {
+				item = obj_tval_kinds[i];
+				total += row[item] - (item ? row[item - 1] : 0);
+				total_great += row_great[item] -
+					(item ? row_great[item - 1] : 0);
+				tval_row[i] = total;
+				tval_row_great[i] = total_great;
+			}
 		}
 	}
 }
@@ -188,8 +231,10 @@ static void cleanup_obj_make(void) {
 	}
 	mem_free(money_type);
 	mem_free(alloc_ego_table);
-	mem_free(obj_total_great);
-	mem_free(obj_total);
+	mem_free(obj_tval_alloc_great);
+	mem_free(obj_tval_alloc);
+	mem_free(obj_tval_kinds);
+	mem_free(obj_tval_start);
 	mem_free(obj_alloc_great);
 	mem_free(obj_alloc);
 }
@@ -1000,39 +1045,48 @@ bool kind_is_good(const struct object_kind *kind)
 }
 
 
+/**
+ * Find the first of `size` cumulative probabilities which exceeds `value`,
+ * returning `size` if there is none.
+ */
+static int alloc_search(const u32b *cumul, int size, u32b value)
+{
+	int low = 0, high = size;
+
+	while (low < high) {
+		int mid = (low + high) / 2;
+
+		if (cumul[mid] > value)
+			high = mid;
+		else
+			low = mid + 1;
+	}
+
+	return low;
+}
+
 /**
  * Choose an object kind of a given tval given a dungeon level.
  */
 static struct object_kind *get_obj_num_by_kind(int level, bool good, int tval)
 {
-	/* This is the base index into obj_alloc for this dlev */
-	size_t ind, item;
+	/* This is the row of the tval tables for this dlev */
+	const u32b *objects = (good ? obj_tval_alloc_great : obj_tval_alloc) +
+		level * z_info->k_max;
+	int start = obj_tval_start[tval];
+	int size = obj_tval_start[tval + 1] - start;
 	u32b value;
-	int total = 0;
-	byte *objects = good ? obj_alloc_great : obj_alloc;
-
-	/* Pick an object */
-	ind = level * z_info->k_max;
-
-	/* Get new total */
-	for (item = 0; item < z_info->k_max; item++)
-		if (objkind_byid(item)->tval == tval)
-			total += objects[ind + item];
 
 	/* No appropriate items of that tval */
-	if (!total) return NULL;
-	
-	value = randint0(total);
-	
-	for (item = 0; item < z_info->k_max; item++)
-		if (objkind_byid(item)->tval == tval) {
-			if (value < objects[ind + item]) break;
-
-			value -= objects[ind + item];
-		}
+	if (!size || !objects[start + size - 1]) return NULL;
+
+	/* Pick an object */
+	value = randint0(objects[start + size - 1]);
 
 	/* Return the item index */
-	return objkind_byid(item);
+	return objkind_byid(obj_tval_kinds[start +
+									   alloc_search(objects + start, size,
+													value)]);
 }
 
 /**
@@ -1042,8 +1096,8 @@ static struct object_kind *get_obj_num_by_kind(int level, bool good, int tval)
  */
 struct object_kind *get_obj_num(int level, bool good, int tval)
 {
-	/* This is the base index into obj_alloc for this dlev */
-	size_t ind, item;
+	/* This is the row of obj_alloc for this dlev */
+	const u32b *objects;
 	u32b value;
 
 	/* Occasional level boost */
@@ -1055,34 +1109,15 @@ struct object_kind *get_obj_num(int level, bool good, int tval)
 	level = MIN(level, z_info->max_obj_depth);
 	level = MAX(level, 0);
 
-	/* Pick an object */
-	ind = level * z_info->k_max;
-	
 	if (tval)
 		return get_obj_num_by_kind(level, good, tval);
-	
-	if (!good) {
-		value = randint0(obj_total[level]);
-		for (item = 0; item < z_info->k_max; item++) {
-			/* Found it */
-			if (value < obj_alloc[ind + item]) break;
-
-			/* Decrement */
-			value -= obj_alloc[ind + item];
-		}
-	} else {
-		value = randint0(obj_total_great[level]);
-		for (item = 0; item < z_info->k_max; item++) {
-			/* Found it */
-			if (value < obj_alloc_great[ind + item]) break;
-
-			/* Decrement */
-			value -= obj_alloc_great[ind + item];
-		}
-	}
+
+	/* Pick an object */
+	objects = (good ? obj_alloc_great : obj_alloc) + level * z_info->k_max;
+	value = randint0(objects[z_info->k_max - 1]);
 
 	/* Return the item index */
-	return objkind_byid(item);
+	return objkind_byid(alloc_search(objects, z_info->k_max, value));
 }
 
 
@@ -1214,7 +1249,7 @@ struct object *make_gold(int lev, char *coin_type)
 	int avg = (16 * lev)/10 + 16;
 	int spread = lev + 10;
 	int value = rand_spread(avg, spread);
-	struct object *new_gold = mem_zalloc(sizeof(*new_gold)); 
+	struct object *new_gold = object_new();
 
 	/* Increase the range to infinite, moving the average to 110% */
 	while (one_in_(100) && value * 10 <= SHRT_MAX)
@@ -276,16 +276,72 @@ bool pile_contains(const struct object *top, const struct object *obj)
 	return false;
 }
 
+/**
+ * Objects are made and thrown away all the time, so rather than going to
+ * mem_zalloc() for each one they are handed out from slabs, and freed ones
+ * are kept on a list (through their `next` field) to be handed out again.
+ * Slabs are never given back; they stay reachable from `object_slabs`.
+ */
+#define OBJECT_SLAB_SIZE 256
+
+struct object_slab {
+	struct object_slab *next;
+	struct object objects[OBJECT_SLAB_SIZE];
+};
+
+static struct object_slab *object_slabs;
+static struct object *object_free_list;
+static struct object_pool_stats object_pool;
+
+/**
+ * Add a new slab to the pool, putting its objects on the free list so they
+ * are handed out in order
+ */
+static void object_pool_grow(void)
+{
+	struct object_slab *slab = mem_alloc(sizeof(*slab));
+	int i;
+
+	slab->next = object_slabs;
+	object_slabs = slab;
+	for (i = OBJECT_SLAB_SIZE - 1; i >= 0; i--) {
+		slab->objects[i].next = object_free_list;
+		object_free_list = &slab->objects[i];
+	}
+
+	object_pool.slabs++;
+	object_pool.capacity += OBJECT_SLAB_SIZE;
+}
+
+/**
+ * Get the occupancy counters for the object pool
+ */
+void object_pool_get_stats(struct object_pool_stats *stats)
+{
+	*stats = object_pool;
+}
+
 /**
  * Create a new object and return it
  */
 struct object *object_new(void)
 {
-	return mem_zalloc(sizeof(struct object));
+	struct object *obj;
+
+	if (!object_free_list)
+		object_pool_grow();
+	obj = object_free_list;
+	object_free_list = obj->next;
+	memset(obj, 0, sizeof(*obj));
+
+	object_pool.allocs++;
+	if (++object_pool.in_use > object_pool.peak)
+		object_pool.peak = object_pool.in_use;
+	return obj;
 }
 
 /**
- * Free up an object
+ * Free up an object, which must have come from object_new()
  *
  * This doesn't affect any game state outside of the object itself
  */
@@ -294,7 +350,13 @@ void object_free(struct object *obj)
 	mem_free(obj->slays);
 	mem_free(obj->brands);
 	mem_free(obj->curses);
-	mem_free(obj);
+
+	/* Poison freed objects the same way mem_free() would */
+	if (mem_flags & MEM_POISON_FREE)
+		memset(obj, 0xCD, sizeof(*obj));
+	obj->next = object_free_list;
+	object_free_list = obj;
+	object_pool.in_use--;
 }
 
 /**
@@ -865,7 +927,7 @@ bool floor_carry(struct chunk *c, int y, int x, struct object *drop, bool *note)
 	drop->held_m_idx = 0;
 
 	/* Link to the first object in the pile */
-	pile_insert(&c->squares[y][x].obj, drop);
+	pile_insert(&c->obj[y][x], drop);
 
 	/* Record in the level list */
 	list_object(c, drop);
@@ -1042,7 +1104,7 @@ void drop_near(struct chunk *c, struct object **dropped, int chance, int y,
 	drop_find_grid(*dropped, &best_y, &best_x);
 	if (floor_carry(c, best_y, best_x, *dropped, &dont_ignore)) {
 		sound(MSG_DROP);
-		if (dont_ignore && (c->squares[best_y][best_x].mon < 0)) {
+		if (dont_ignore && (c->mon[best_y][best_x] < 0)) {
 			msg("You feel something roll beneath your feet.");
 		}
 	} else {
@@ -1084,7 +1146,7 @@ void push_object(int y, int x)
 	}
 
 	/* Disassociate the objects from the square */
-	cave->squares[y][x].obj = NULL;
+	cave->obj[y][x] = NULL;
 
 	/* Set feature to an open door */
 	square_force_floor(cave, y, x);
@@ -48,6 +48,18 @@ typedef enum
 	OFLOOR_VISIBLE = 0x08, /* Visible items only */
 } object_floor_t;
 
+/**
+ * Occupancy counters for the pool struct objects are allocated from
+ */
+struct object_pool_stats {
+	int slabs;			/* Slabs allocated */
+	int capacity;		/* Objects the slabs hold */
+	int in_use;			/* Objects handed out and not yet freed */
+	int peak;			/* Most objects ever in use at once */
+	long allocs;		/* Calls to object_new() */
+};
+
+void object_pool_get_stats(struct object_pool_stats *stats);
 struct object *object_new(void);
 void object_free(struct object *obj);
 void object_delete(struct object **obj_address);
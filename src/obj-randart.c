@@ -2704,6 +2704,9 @@ void create_artifact_set(struct artifact_set_data *data)
 		aidx++;
 	}
 
+	/* The artifacts have new names */
+	reset_object_lookups();
+
 	mem_free(tval_total);
 }
 
@@ -41,6 +41,7 @@
 #include "player-spell.h"
 #include "player-util.h"
 #include "randname.h"
+#include "z-lookup.h"
 #include "z-queue.h"
 
 struct object_base *kb_info;
@@ -324,21 +325,153 @@ unsigned check_for_inscrip(const struct object *obj, const char *inscrip)
 	return i;
 }
 
-/*** Object kind lookup functions ***/
+/*** Lookup indexes ***/
 
 /**
- * Return the object kind with the given `tval` and `sval`, or NULL.
+ * Object kinds are found by tval and sval through a table for each tval
+ * indexed by sval, and by tval and name through a hash table.  Artifacts
+ * and ego items are found by name through hash tables.  The indexes are
+ * built on first use, rebuilt if the array they index has been reallocated
+ * or resized, and thrown away by reset_object_lookups().
  */
-struct object_kind *lookup_kind(int tval, int sval)
+static struct object_kind **kind_svals[TV_MAX];
+static int kind_svals_size[TV_MAX];
+static struct name_index *kind_names;
+static struct name_index *artifact_names;
+static struct name_index *ego_names;
+
+static const struct object_kind *kinds_indexed;
+static int kinds_indexed_size;
+static const struct artifact *artifacts_indexed;
+static int artifacts_indexed_size;
+static const struct ego_item *egos_indexed;
+static int egos_indexed_size;
+
+static void free_kind_indexes(void)
+{
+	int tval;
+
+	for (tval = 0; tval < TV_MAX; tval++) {
+		mem_free(kind_svals[tval]);
+		kind_svals[tval] = NULL;
+		kind_svals_size[tval] = 0;
+	}
+	name_index_free(kind_names);
+	kind_names = NULL;
+	kinds_indexed = NULL;
+}
+
+/**
+ * Make sure the object kind indexes are up to date
+ */
+static void index_kinds(void)
 {
-	int k;
+	int k, tval;
 
-	/* Look for it */
+	if (kind_names && kinds_indexed == k_info &&
+		kinds_indexed_size == z_info->k_max)
+		return;
+
+	free_kind_indexes();
+	kind_names = name_index_new(true);
+	kinds_indexed = k_info;
+	kinds_indexed_size = z_info->k_max;
+
+	/* Size the sval tables */
+	for (k = 0; k < z_info->k_max; k++) {
+		struct object_kind *kind = &k_info[k];
+
+		if (kind->tval < 0 || kind->tval >= TV_MAX || kind->sval < 0)
+			continue;
+		if (kind->sval >= kind_svals_size[kind->tval])
+			kind_svals_size[kind->tval] = kind->sval + 1;
+	}
+	for (tval = 0; tval < TV_MAX; tval++)
+		if (kind_svals_size[tval])
+			kind_svals[tval] = mem_zalloc(kind_svals_size[tval] *
+										  sizeof(struct object_kind *));
+
+	/* Fill them, and the names, keeping the first kind of each */
 	for (k = 0; k < z_info->k_max; k++) {
 		struct object_kind *kind = &k_info[k];
-		if (kind->tval == tval && kind->sval == sval)
-			return kind;
+		char cmp_name[1024];
+
+		if (kind->tval >= 0 && kind->tval < TV_MAX && kind->sval >= 0 &&
+			!kind_svals[kind->tval][kind->sval])
+			kind_svals[kind->tval][kind->sval] = kind;
+
+		if (kind->name) {
+			obj_desc_name_format(cmp_name, sizeof cmp_name, 0, kind->name, 0,
+								 false);
+			name_index_add(kind_names, kind->tval, cmp_name, k);
+		}
 	}
+}
+
+/**
+ * Make sure the artifact and ego name indexes are up to date
+ */
+static void index_artifacts(void)
+{
+	int i;
+
+	if (artifact_names && artifacts_indexed == a_info &&
+		artifacts_indexed_size == z_info->a_max)
+		return;
+
+	name_index_free(artifact_names);
+	artifact_names = name_index_new(false);
+	artifacts_indexed = a_info;
+	artifacts_indexed_size = z_info->a_max;
+	for (i = 0; i < z_info->a_max; i++)
+		if (a_info[i].name)
+			name_index_add(artifact_names, 0, a_info[i].name, i);
+}
+
+static void index_egos(void)
+{
+	int i;
+
+	if (ego_names && egos_indexed == e_info &&
+		egos_indexed_size == z_info->e_max)
+		return;
+
+	name_index_free(ego_names);
+	ego_names = name_index_new(false);
+	egos_indexed = e_info;
+	egos_indexed_size = z_info->e_max;
+	for (i = 0; i < z_info->e_max; i++)
+		if (e_info[i].name)
+			name_index_add(ego_names, 0, e_info[i].name, i);
+}
+
+/**
+ * Throw away the lookup indexes, for when object kinds, artifacts or ego
+ * items are freed or renamed
+ */
+void reset_object_lookups(void)
+{
+	free_kind_indexes();
+	name_index_free(artifact_names);
+	artifact_names = NULL;
+	artifacts_indexed = NULL;
+	name_index_free(ego_names);
+	ego_names = NULL;
+	egos_indexed = NULL;
+}
+
+/*** Object kind lookup functions ***/
+
+/**
+ * Return the object kind with the given `tval` and `sval`, or NULL.
+ */
+struct object_kind *lookup_kind(int tval, int sval)
+{
+	/* Look for it */
+	index_kinds();
+	if (tval >= 0 && tval < TV_MAX && sval >= 0 &&
+		sval < kind_svals_size[tval] && kind_svals[tval][sval])
+		return kind_svals[tval][sval];
 
 	/* Failure */
 	msg("No object: %d:%d (%s)", tval, sval, tval_find_name(tval));
@@ -359,22 +492,17 @@ struct object_kind *objkind_byid(int kidx) {
  */
 struct artifact *lookup_artifact_name(const char *name)
 {
-	int i;
-	int a_idx = -1;
+	int a_idx;
 
-	/* Look for it */
-	for (i = 0; i < z_info->a_max; i++) {
-		struct artifact *art = &a_info[i];
-
-		/* Test for equality */
-		if (art->name && streq(name, art->name))
-			return art;
-		
-		/* Test for close matches */
-		if (strlen(name) >= 3 && art->name && my_stristr(art->name, name)
-			&& a_idx == -1)
-			a_idx = i;
-	}
+	/* Test for equality */
+	index_artifacts();
+	a_idx = name_index_find(artifact_names, 0, name);
+	if (a_idx >= 0)
+		return &a_info[a_idx];
+
+	/* Look for close matches */
+	if (strlen(name) < 3) return NULL;
+	a_idx = name_index_find_part(artifact_names, name);
 
 	/* Return our best match */
 	return a_idx > 0 ? &a_info[a_idx] : NULL;
@@ -388,20 +516,19 @@ struct artifact *lookup_artifact_name(const char *name)
  */
 struct ego_item *lookup_ego_item(const char *name, int tval, int sval)
 {
-	int i;
+	struct object_kind *kind = NULL;
+	int e_idx;
 
-	/* Look for it */
-	for (i = 0; i < z_info->e_max; i++) {
-		struct ego_item *ego = &e_info[i];
+	/* Go through the egos with that name */
+	index_egos();
+	for (e_idx = name_index_find(ego_names, 0, name); e_idx >= 0;
+		 e_idx = name_index_find_after(ego_names, 0, name, e_idx)) {
+		struct ego_item *ego = &e_info[e_idx];
 		struct poss_item *poss_item = ego->poss_items;
 
-		/* Reject nameless and wrong names */
-		if (!ego->name) continue;
-		if (!streq(name, ego->name)) continue;
-
 		/* Check tval and sval */
 		while (poss_item) {
-			struct object_kind *kind = lookup_kind(tval, sval);
+			if (!kind) kind = lookup_kind(tval, sval);
 			if (kind->kidx == poss_item->kidx) {
 				return ego;
 			}
@@ -418,26 +545,17 @@ struct ego_item *lookup_ego_item(const char *name, int tval, int sval)
  */
 int lookup_sval(int tval, const char *name)
 {
-	int k;
 	unsigned int r;
+	int k_idx;
 
 	if (sscanf(name, "%u", &r) == 1)
 		return r;
 
 	/* Look for it */
-	for (k = 0; k < z_info->k_max; k++) {
-		struct object_kind *kind = &k_info[k];
-		char cmp_name[1024];
-
-		if (!kind || !kind->name) continue;
-
-		obj_desc_name_format(cmp_name, sizeof cmp_name, 0, kind->name, 0,
-							 false);
-
-		/* Found a match */
-		if (kind->tval == tval && !my_stricmp(cmp_name, name))
-			return kind->sval;
-	}
+	index_kinds();
+	k_idx = name_index_find(kind_names, tval, name);
+	if (k_idx >= 0)
+		return k_info[k_idx].sval;
 
 	return -1;
 }
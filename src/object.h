@@ -370,8 +370,8 @@ struct curse_data {
  * Note that inscriptions are now handled via the "quark_str()" function
  * applied to the "note" field, which will return NULL if "note" is zero.
  *
- * Each cave grid points to one (or zero) objects via the "obj" field in
- * its "squares" struct.  Each object then points to one (or zero) objects
+ * Each cave grid points to one (or zero) objects via its entry in the
+ * chunk's "obj" array.  Each object then points to one (or zero) objects
  * via the "next" field, and (aside from the first) back via its "prev"
  * field, forming a doubly linked list, which in game terms represents a
  * stack of objects in the same grid.
@@ -29,10 +29,12 @@
 
 /**
  * A parser has a list of hooks (which are run across new lines given to
- * parser_parse()) and a list of the set of named values for the current line.
- * Each hook has a list of specs, which are essentially named formal parameters;
- * when we run a particular hook across a line, each spec in the hook is
- * assigned a value.
+ * parser_parse()) and the set of values for the current line.  Each hook has
+ * an array of specs, which are essentially named formal parameters; when we
+ * run a particular hook across a line, each spec in the hook is assigned a
+ * value in the slot with the same position.  Hooks are found by directive
+ * through a hash table, and the values of a line live in buffers kept by the
+ * parser from line to line, so parsing a line allocates nothing.
  */
 
 enum {
@@ -47,13 +49,11 @@ enum {
 };
 
 struct parser_spec {
-	struct parser_spec *next;
 	int type;
 	const char *name;
 };
 
 struct parser_value {
-	struct parser_spec spec;
 	union {
 		wchar_t cval;
 		int ival;
@@ -67,8 +67,8 @@ struct parser_hook {
 	struct parser_hook *next;
 	enum parser_error (*func)(struct parser *p);
 	char *dir;
-	struct parser_spec *fhead;
-	struct parser_spec *ftail;
+	struct parser_spec *specs;
+	int nspecs;
 };
 
 struct parser {
@@ -77,49 +77,111 @@ struct parser {
 	unsigned int colno;
 	char errmsg[1024];
 	struct parser_hook *hooks;
-	struct parser_value *fhead;
-	struct parser_value *ftail;
+	struct parser_hook **table;
+	size_t table_size;
+	size_t nhooks;
+	struct parser_hook *hook;
+	struct parser_value *values;
+	int nvalues;
+	int maxvalues;
+	char *line;
+	size_t line_size;
 	void *priv;
 };
 
+#define PARSER_TABLE_INIT	32
+
 /**
  * Allocates a new parser.
  */
 struct parser *parser_new(void) {
 	struct parser *p = mem_zalloc(sizeof *p);
+	p->table_size = PARSER_TABLE_INIT;
+	p->table = mem_zalloc(p->table_size * sizeof(*p->table));
 	return p;
 }
 
+/**
+ * Find the hash table slot for a directive: the slot holding its hook if
+ * it has one, otherwise the empty slot where its hook should go.
+ */
+static size_t hookslot(struct parser *p, const char *dir) {
+	size_t mask = p->table_size - 1;
+	size_t slot = djb2_hash(dir) & mask;
+
+	while (p->table[slot] && strcmp(p->table[slot]->dir, dir))
+		slot = (slot + 1) & mask;
+	return slot;
+}
+
 static struct parser_hook *findhook(struct parser *p, const char *dir) {
-	struct parser_hook *h = p->hooks;
-	while (h) {
-		if (!strcmp(h->dir, dir))
-			break;
-		h = h->next;
+	return p->table[hookslot(p, dir)];
+}
+
+/**
+ * Makes a hook the one run for its directive, superseding any earlier one.
+ */
+static void addhook(struct parser *p, struct parser_hook *h) {
+	size_t slot = hookslot(p, h->dir);
+
+	if (!p->table[slot])
+		p->nhooks++;
+	p->table[slot] = h;
+
+	/* Keep the table no more than half full */
+	if (p->nhooks * 2 > p->table_size) {
+		struct parser_hook **old = p->table;
+		size_t i, old_size = p->table_size;
+
+		p->table_size *= 2;
+		p->table = mem_zalloc(p->table_size * sizeof(*p->table));
+		for (i = 0; i < old_size; i++)
+			if (old[i])
+				p->table[hookslot(p, old[i]->dir)] = old[i];
+		mem_free(old);
 	}
-	return h;
 }
 
 static void parser_freeold(struct parser *p) {
-	struct parser_value *v;
-	while (p->fhead) {
-		int t = p->fhead->spec.type & ~PARSE_T_OPT;
-		v = (struct parser_value *)p->fhead->spec.next;
-		if (t == PARSE_T_SYM || t == PARSE_T_STR)
-			mem_free(p->fhead->u.sval);
-		mem_free(p->fhead);
-		p->fhead = v;
-	}
+	p->hook = NULL;
+	p->nvalues = 0;
+}
+
+/**
+ * Reads a decimal integer, as sscanf() would for "%d", advancing `s` past
+ * it.  Returns false if there is no integer at `s`.
+ */
+static bool parse_random_int(char **s, int *value) {
+	char *end;
+	long v = strtol(*s, &end, 10);
+
+	if (end == *s)
+		return false;
+	*value = (int) v;
+	*s = end;
+	return true;
+}
+
+/**
+ * Reads "<dice>d<sides>" or "d<sides>", the latter meaning one die.
+ */
+static bool parse_random_dice(char **s, int *dice, int *sides) {
+	if (**s == 'd')
+		*dice = 1;
+	else if (!parse_random_int(s, dice) || **s != 'd')
+		return false;
+	(*s)++;
+	return parse_random_int(s, sides);
 }
 
 static bool parse_random(const char *str, random_value *bonus) {
 	bool negative = false;
 
 	char buffer[50];
-	int i = 0, b, dn, ds, mb;
+	char *s;
+	int i = 0, b = 0, dn = 0, ds = 0, mb = 0;
 	
 	const char end_chr = '|';
-	char eov;
 
 	/* Entire value may be negated */
 	if (str[0] == '-') {
@@ -135,49 +197,54 @@ static bool parse_random(const char *str, random_value *bonus) {
 		return false;
 
 	/*
-	 * Add a sentinal value at the end of the string.
-	 * Used by scanf to make sure there's no text after the final conversion.
+	 * Add a sentinal value at the end of the string, which must follow the
+	 * last component directly.
 	 */
 	buffer[strlen(buffer) + 1] = '\0';
 	buffer[strlen(buffer)] = end_chr;
 
-	/* Scan the value, apply defaults for unspecified components */
-	if (5 == sscanf(buffer, "%d+%dd%dM%d%c", &b, &dn, &ds, &mb, &eov) &&
-		eov == end_chr) {
-	} else if (4 == sscanf(buffer, "%d+d%dM%d%c", &b, &ds, &mb, &eov) &&
-			   eov == end_chr) {
-		dn = 1;
-	} else if (3 == sscanf(buffer, "%d+M%d%c", &b, &mb, &eov) &&
-			   eov == end_chr) {
-		dn = 0; ds = 0;
-	} else if (4 == sscanf(buffer, "%d+%dd%d%c", &b, &dn, &ds, &eov) &&
-			   eov == end_chr) {
-		mb = 0;
-	} else if (3 == sscanf(buffer, "%d+d%d%c", &b, &ds, &eov) &&
-			   eov == end_chr) {
-		dn = 1; mb = 0;
-	} else if (4 == sscanf(buffer, "%dd%dM%d%c", &dn, &ds, &mb, &eov) &&
-			   eov == end_chr) {
-		b = 0;
-	} else if (3 == sscanf(buffer, "d%dM%d%c", &ds, &mb, &eov) &&
-			   eov == end_chr) {
-		b = 0; dn = 1;
-	} else if (2 == sscanf(buffer, "M%d%c", &mb, &eov) &&
-			   eov == end_chr) {
-		b = 0; dn = 0; ds = 0;
-	} else if (3 == sscanf(buffer, "%dd%d%c", &dn, &ds, &eov) &&
-			   eov == end_chr) {
-		b = 0; mb = 0;
-	} else if (2 == sscanf(buffer, "d%d%c", &ds, &eov) &&
-			   eov == end_chr) {
-		b = 0; dn = 1; mb = 0;
-	} else if (2 == sscanf(buffer, "%d%c", &b, &eov) &&
-			   eov == end_chr) {
-		dn = 0; ds = 0; mb = 0;
-	} else {
-		return false;
+	/*
+	 * Scan the value in one pass, apply defaults for unspecified components.
+	 * The accepted forms are <base>, [<base>+][<dice>]d<sides>[M<m_bonus>]
+	 * and [<base>+]M<m_bonus>.
+	 */
+	s = buffer;
+	if (*s == 'd') {
+		if (!parse_random_dice(&s, &dn, &ds))
+			return false;
+	} else if (*s != 'M') {
+		/* Either the base or the number of dice */
+		if (!parse_random_int(&s, &b))
+			return false;
+
+		if (*s == 'd') {
+			/* It was the number of dice */
+			dn = b;
+			b = 0;
+			s++;
+			if (!parse_random_int(&s, &ds))
+				return false;
+		} else if (*s == '+') {
+			/* Dice or a magic bonus must follow the base */
+			s++;
+			if (*s != 'M' && !parse_random_dice(&s, &dn, &ds))
+				return false;
+		} else if (*s != end_chr) {
+			return false;
+		}
 	}
 
+	/* Optional magic bonus */
+	if (*s == 'M') {
+		s++;
+		if (!parse_random_int(&s, &mb))
+			return false;
+	}
+
+	/* Nothing may follow */
+	if (*s != end_chr)
+		return false;
+
 	/* Assign the values */
 	bonus->base = b;
 	bonus->dice = dn;
@@ -209,6 +276,7 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	struct parser_spec *s;
 	struct parser_value *v;
 	char *sp = NULL;
+	size_t len;
 
 	assert(p);
 	assert(line);
@@ -217,8 +285,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 
 	p->lineno++;
 	p->colno = 1;
-	p->fhead = NULL;
-	p->ftail = NULL;
 
 	/* Ignore empty lines and comments. */
 	while (*line && (isspace(*line)))
@@ -226,11 +292,18 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!*line || *line == '#')
 		return PARSE_ERROR_NONE;
 
-	cline = string_make(line);
+	/* Copy the line into the parser's buffer; string values point into it */
+	len = strlen(line) + 1;
+	if (len > p->line_size) {
+		p->line_size = MAX(len, 2 * p->line_size);
+		mem_free(p->line);
+		p->line = mem_alloc(p->line_size);
+	}
+	cline = p->line;
+	memcpy(cline, line, len);
 
 	tok = strtok(cline, ":");
 	if (!tok) {
-		mem_free(cline);
 		p->error = PARSE_ERROR_MISSING_FIELD;
 		return PARSE_ERROR_MISSING_FIELD;
 	}
@@ -239,7 +312,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!h) {
 		my_strcpy(p->errmsg, tok, sizeof(p->errmsg));
 		p->error = PARSE_ERROR_UNDEFINED_DIRECTIVE;
-		mem_free(cline);
 		return PARSE_ERROR_UNDEFINED_DIRECTIVE;
 	}
 
@@ -247,7 +319,8 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	 * types. The optional flag has a bit assigned to it in the spec's type
 	 * tag; we compute a temporary type for the spec with that flag removed
 	 * and use that instead. */
-	for (s = h->fhead; s; s = s->next) {
+	p->hook = h;
+	for (s = h->specs; s < h->specs + h->nspecs; s++) {
 		int t = s->type & ~PARSE_T_OPT;
 		p->colno++;
 
@@ -269,25 +342,19 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			if (!(s->type & PARSE_T_OPT)) {
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_MISSING_FIELD;
-				mem_free(cline);
 				return PARSE_ERROR_MISSING_FIELD;
 			}
 			break;
 		}
 
-		/* Allocate a value node. */
-		v = mem_alloc(sizeof *v);
-		v->spec.next = NULL;
-		v->spec.type = s->type;
-		v->spec.name = s->name;
+		/* Use the value slot for this spec. */
+		v = &p->values[s - h->specs];
 
 		/* Parse out its value. */
 		if (t == PARSE_T_INT) {
 			char *z = NULL;
 			v->u.ival = strtol(tok, &z, 0);
 			if (z == tok) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -296,8 +363,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			char *z = NULL;
 			v->u.uval = strtoul(tok, &z, 0);
 			if (z == tok || *tok == '-') {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -305,27 +370,19 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		} else if (t == PARSE_T_CHAR) {
 			text_mbstowcs(&v->u.cval, tok, 1);
 		} else if (t == PARSE_T_SYM || t == PARSE_T_STR) {
-			v->u.sval = string_make(tok);
+			v->u.sval = tok;
 		} else if (t == PARSE_T_RAND) {
 			if (!parse_random(tok, &v->u.rval)) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_RANDOM;
 				return PARSE_ERROR_NOT_RANDOM;
 			}
 		}
 
-		/* Link it into the value list. */
-		if (!p->fhead)
-			p->fhead = v;
-		else
-			p->ftail->spec.next = &v->spec;
-		p->ftail = v;
+		/* Count it as present. */
+		p->nvalues++;
 	}
 
-	mem_free(cline);
-
 	p->error = h->func(p);
 	return p->error;
 }
@@ -368,14 +425,13 @@ static int parse_type(const char *s) {
 }
 
 static void clean_specs(struct parser_hook *h) {
-	struct parser_spec *s;
+	int i;
 	mem_free(h->dir);
-	while (h->fhead) {
-		s = h->fhead;
-		h->fhead = h->fhead->next;
-		mem_free((void*)s->name);
-		mem_free(s);
-	}
+	for (i = 0; i < h->nspecs; i++)
+		mem_free((void*)h->specs[i].name);
+	mem_free(h->specs);
+	h->specs = NULL;
+	h->nspecs = 0;
 }
 
 /**
@@ -390,6 +446,9 @@ void parser_destroy(struct parser *p) {
 		mem_free(p->hooks);
 		p->hooks = h;
 	}
+	mem_free(p->table);
+	mem_free(p->values);
+	mem_free(p->line);
 	mem_free(p);
 }
 
@@ -406,9 +465,11 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 	if (!name)
 		return -EINVAL;
 	h->dir = string_make(name);
-	h->fhead = NULL;
-	h->ftail = NULL;
+	h->specs = NULL;
+	h->nspecs = 0;
 	while (name) {
+		struct parser_spec *last = h->nspecs ? &h->specs[h->nspecs - 1] : NULL;
+
 		/* Lack of a type is legal; that means we're at the end of the line. */
 		stype = strtok(NULL, " ");
 		if (!stype)
@@ -428,26 +489,20 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 			clean_specs(h);
 			return -EINVAL;
 		}
-		if (!(type & PARSE_T_OPT) && h->ftail &&
-			(h->ftail->type & PARSE_T_OPT)) {
+		if (!(type & PARSE_T_OPT) && last && (last->type & PARSE_T_OPT)) {
 			clean_specs(h);
 			return -EINVAL;
 		}
-		if (h->ftail && ((h->ftail->type & ~PARSE_T_OPT) == PARSE_T_STR)) {
+		if (last && ((last->type & ~PARSE_T_OPT) == PARSE_T_STR)) {
 			clean_specs(h);
 			return -EINVAL;
 		}
 
-		/* Save this spec. */
-		s = mem_alloc(sizeof *s);
+		/* Save this spec in the next slot. */
+		h->specs = mem_realloc(h->specs, (h->nspecs + 1) * sizeof *s);
+		s = &h->specs[h->nspecs++];
 		s->type = type;
 		s->name = string_make(name);
-		s->next = NULL;
-		if (h->fhead)
-			h->ftail->next = s;
-		else
-			h->fhead = s;
-		h->ftail = s;
 	}
 
 	return 0;
@@ -488,6 +543,15 @@ errr parser_reg(struct parser *p, const char *fmt,
 	}
 
 	p->hooks = h;
+	addhook(p, h);
+
+	/* Make sure there are enough value slots for this hook */
+	if (h->nspecs > p->maxvalues) {
+		p->maxvalues = h->nspecs;
+		p->values = mem_realloc(p->values,
+								p->maxvalues * sizeof(struct parser_value));
+	}
+
 	mem_free(cfmt);
 	return 0;
 }
@@ -505,19 +569,21 @@ enum parser_error ignored(struct parser *p) {
  * Used to test for presence of optional values.
  */
 bool parser_hasval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (!strcmp(v->spec.name, name))
+	int i;
+	for (i = 0; i < p->nvalues; i++) {
+		if (!strcmp(p->hook->specs[i].name, name))
 			return true;
 	}
 	return false;
 }
 
-static struct parser_value *parser_getval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (!strcmp(v->spec.name, name)) {
-			return v;
+static struct parser_value *parser_getval(struct parser *p, const char *name,
+										  int type) {
+	int i;
+	for (i = 0; i < p->nvalues; i++) {
+		if (!strcmp(p->hook->specs[i].name, name)) {
+			assert((p->hook->specs[i].type & ~PARSE_T_OPT) == type);
+			return &p->values[i];
 		}
 	}
 	quit_fmt("parser_getval error: name is %s\n", name);
@@ -528,8 +594,7 @@ static struct parser_value *parser_getval(struct parser *p, const char *name) {
  * Returns the symbol named `name`. This symbol must exist.
  */
 const char *parser_getsym(struct parser *p, const char *name) {
-	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_SYM);
+	struct parser_value *v = parser_getval(p, name, PARSE_T_SYM);
 	return v->u.sval;
 }
 
@@ -537,8 +602,7 @@ const char *parser_getsym(struct parser *p, const char *name) {
  * Returns the integer named `name`. This symbol must exist.
  */
 int parser_getint(struct parser *p, const char *name) {
-	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_INT);
+	struct parser_value *v = parser_getval(p, name, PARSE_T_INT);
 	return v->u.ival;
 }
 
@@ -546,8 +610,7 @@ int parser_getint(struct parser *p, const char *name) {
  * Returns the unsigned integer named `name`. This symbol must exist.
  */
 unsigned int parser_getuint(struct parser *p, const char *name) {
-	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_UINT);
+	struct parser_value *v = parser_getval(p, name, PARSE_T_UINT);
 	return v->u.uval;
 }
 
@@ -555,8 +618,7 @@ unsigned int parser_getuint(struct parser *p, const char *name) {
  * Returns the string named `name`. This symbol must exist.
  */
 const char *parser_getstr(struct parser *p, const char *name) {
-	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_STR);
+	struct parser_value *v = parser_getval(p, name, PARSE_T_STR);
 	return v->u.sval;
 }
 
@@ -564,8 +626,7 @@ const char *parser_getstr(struct parser *p, const char *name) {
  * Returns the random value named `name`. This symbol must exist.
  */
 struct random parser_getrand(struct parser *p, const char *name) {
-	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_RAND);
+	struct parser_value *v = parser_getval(p, name, PARSE_T_RAND);
 	return v->u.rval;
 }
 
@@ -573,8 +634,7 @@ struct random parser_getrand(struct parser *p, const char *name) {
  * Returns the character named `name`. This symbol must exist.
  */
 wchar_t parser_getchar(struct parser *p, const char *name) {
-	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_CHAR);
+	struct parser_value *v = parser_getval(p, name, PARSE_T_CHAR);
 	return v->u.cval;
 }
 
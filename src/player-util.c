@@ -904,14 +904,14 @@ int coords_to_dir(struct player *p, int y, int x)
  */
 void player_place(struct chunk *c, struct player *p, int y, int x)
 {
-	assert(!c->squares[y][x].mon);
+	assert(!c->mon[y][x]);
 
 	/* Save player location */
 	p->py = y;
 	p->px = x;
 
 	/* Mark cave grid */
-	c->squares[y][x].mon = -1;
+	c->mon[y][x] = -1;
 
 	/* Clear stair creation */
 	p->upkeep->create_down_stair = false;
@@ -51,7 +51,7 @@ static void project_feature_handler_LIGHT_WEAK(project_feature_handler_context_t
 	const int y = context->y;
 
 	/* Turn on the light */
-	sqinfo_on(cave->squares[y][x].info, SQUARE_GLOW);
+	sqinfo_on(cave->info[y][x], SQUARE_GLOW);
 
 	/* Grid is in line of sight */
 	if (square_isview(cave, y, x)) {
@@ -73,7 +73,7 @@ static void project_feature_handler_DARK_WEAK(project_feature_handler_context_t
 
 	if (player->depth != 0 || !is_daytime())
 		/* Turn off the light */
-		sqinfo_off(cave->squares[y][x].info, SQUARE_GLOW);
+		sqinfo_off(cave->info[y][x], SQUARE_GLOW);
 
 	/* Grid is in line of sight */
 	if (square_isview(cave, y, x)) {
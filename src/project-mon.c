@@ -792,6 +792,7 @@ static bool project_m_monster_attack(project_monster_handler_context_t *context,
 
 	/* Hurt the monster */
 	mon->hp -= dam;
+	monster_end_dormancy(cave, mon);
 
 	/* Dead or damaged monster */
 	if (mon->hp < 0) {
@@ -1033,7 +1034,7 @@ void project_m(struct source origin, int r, int y, int x,
 	/* Are we trying to id the source of this effect? */
 	bool id = (origin.what == SRC_PLAYER) ? !obvious : false;
 
-	int m_idx = cave->squares[y][x].mon;
+	int m_idx = cave->mon[y][x];
 
 	project_monster_handler_f monster_handler = monster_handlers[typ];
 	project_monster_handler_context_t context = {
@@ -202,7 +202,7 @@ int project_path(struct loc *gp, int range, int y1, int x1, int y2, int x2, int
 
 			/* Sometimes stop at non-initial monsters/players */
 			if (flg & (PROJECT_STOP))
-				if ((n > 0) && (cave->squares[y][x].mon != 0)) break;
+				if ((n > 0) && (cave->mon[y][x] != 0)) break;
 
 			/* Slant */
 			if (m) {
@@ -256,7 +256,7 @@ int project_path(struct loc *gp, int range, int y1, int x1, int y2, int x2, int
 
 			/* Sometimes stop at non-initial monsters/players */
 			if (flg & (PROJECT_STOP))
-				if ((n > 0) && (cave->squares[y][x].mon != 0)) break;
+				if ((n > 0) && (cave->mon[y][x] != 0)) break;
 
 			/* Slant */
 			if (m) {
@@ -304,7 +304,7 @@ int project_path(struct loc *gp, int range, int y1, int x1, int y2, int x2, int
 
 			/* Sometimes stop at non-initial monsters/players */
 			if (flg & (PROJECT_STOP))
-				if ((n > 0) && (cave->squares[y][x].mon != 0)) break;
+				if ((n > 0) && (cave->mon[y][x] != 0)) break;
 
 			/* Advance */
 			y += sy;
@@ -628,7 +628,7 @@ bool project(struct source origin, int rad, int y, int x,
 		blast_grid[num_grids].y = y;
 		blast_grid[num_grids].x = x;
 		distance_to_grid[num_grids] = 0;
-		sqinfo_on(cave->squares[y][x].info, SQUARE_PROJECT);
+		sqinfo_on(cave->info[y][x], SQUARE_PROJECT);
 		num_grids++;
 	}
 
@@ -673,7 +673,7 @@ bool project(struct source origin, int rad, int y, int x,
 					blast_grid[num_grids].y = y;
 					blast_grid[num_grids].x = x;
 					distance_to_grid[num_grids] = 0;
-					sqinfo_on(cave->squares[y][x].info, SQUARE_PROJECT);
+					sqinfo_on(cave->info[y][x], SQUARE_PROJECT);
 					num_grids++;
 				}
 
@@ -682,7 +682,7 @@ bool project(struct source origin, int rad, int y, int x,
 					blast_grid[num_grids].y = y;
 					blast_grid[num_grids].x = x;
 					distance_to_grid[num_grids] = 0;
-					sqinfo_on(cave->squares[y][x].info, SQUARE_PROJECT);
+					sqinfo_on(cave->info[y][x], SQUARE_PROJECT);
 					num_grids++;
 				}
 
@@ -738,7 +738,7 @@ bool project(struct source origin, int rad, int y, int x,
 			blast_grid[num_grids].y = centre.y;
 			blast_grid[num_grids].x = centre.x;
 			distance_to_grid[num_grids] = 0;
-			sqinfo_on(cave->squares[centre.y][centre.x].info, SQUARE_PROJECT);
+			sqinfo_on(cave->info[centre.y][centre.x], SQUARE_PROJECT);
 			num_grids++;
 		}
 
@@ -799,7 +799,7 @@ bool project(struct source origin, int rad, int y, int x,
 						blast_grid[num_grids].y = y;
 						blast_grid[num_grids].x = x;
 						distance_to_grid[num_grids] = dist_from_centre;
-						sqinfo_on(cave->squares[y][x].info, SQUARE_PROJECT);
+						sqinfo_on(cave->info[y][x], SQUARE_PROJECT);
 						num_grids++;
 					}
 				}
@@ -830,7 +830,7 @@ bool project(struct source origin, int rad, int y, int x,
 							blast_grid[num_grids].y = y;
 							blast_grid[num_grids].x = x;
 							distance_to_grid[num_grids] = dist_from_centre;
-							sqinfo_on(cave->squares[y][x].info, SQUARE_PROJECT);
+							sqinfo_on(cave->info[y][x], SQUARE_PROJECT);
 							num_grids++;
 						}
 					}
@@ -966,7 +966,7 @@ bool project(struct source origin, int rad, int y, int x,
 			y = last_hit_y;
 
 			/* Track if possible */
-			if (cave->squares[y][x].mon > 0) {
+			if (cave->mon[y][x] > 0) {
 				struct monster *mon = square_monster(cave, y, x);
 
 				/* Recall and track */
@@ -1019,7 +1019,7 @@ bool project(struct source origin, int rad, int y, int x,
 		x = blast_grid[i].x;
 
 		/* Clear the mark */
-		sqinfo_off(cave->squares[y][x].info, SQUARE_PROJECT);
+		sqinfo_off(cave->info[y][x], SQUARE_PROJECT);
 	}
 
 	/* Update stuff if needed */
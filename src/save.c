@@ -19,9 +19,11 @@
 #include "angband.h"
 #include "cave.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "monster.h"
 #include "object.h"
 #include "obj-desc.h"
@@ -131,8 +133,7 @@ static void wr_item(const struct object *obj)
 	}
 	wr_byte(obj->notice);
 
-	for (i = 0; i < OF_SIZE; i++)
-		wr_byte(obj->flags[i]);
+	wr_bytes(obj->flags, OF_SIZE);
 
 	for (i = 0; i < OBJ_MOD_MAX; i++) {
 		wr_s16b(obj->modifiers[i]);
@@ -214,14 +215,9 @@ static void wr_monster(const struct monster *mon)
 	wr_byte(mon->energy);
 	wr_byte(MON_TMD_MAX);
 
-	for (j = 0; j < MON_TMD_MAX; j++)
-		wr_s16b(mon->m_timed[j]);
-
-	for (j = 0; j < MFLAG_SIZE; j++)
-		wr_byte(mon->mflag[j]);
-
-	for (j = 0; j < OF_SIZE; j++)
-		wr_byte(mon->known_pstate.flags[j]);
+	wr_s16b_array(mon->m_timed, MON_TMD_MAX);
+	wr_bytes(mon->mflag, MFLAG_SIZE);
+	wr_bytes(mon->known_pstate.flags, OF_SIZE);
 
 	for (j = 0; j < ELEM_MAX; j++)
 		wr_s16b(mon->known_pstate.el_info[j].res_level);
@@ -246,8 +242,6 @@ static void wr_monster(const struct monster *mon)
  */
 static void wr_trap(struct trap *trap)
 {
-    size_t i;
-
 	if (trap->t_idx) {
 		wr_string(trap_info[trap->t_idx].desc);
 	} else {
@@ -258,8 +252,7 @@ static void wr_trap(struct trap *trap)
     wr_byte(trap->power);
     wr_byte(trap->timeout);
 
-    for (i = 0; i < TRF_SIZE; i++)
-		wr_byte(trap->flags[i]);
+    wr_bytes(trap->flags, TRF_SIZE);
 }
 
 /**
@@ -422,10 +415,10 @@ void wr_player(void)
 
 	/* Dump the stats (maximum and current and birth and swap-mapping) */
 	wr_byte(STAT_MAX);
-	for (i = 0; i < STAT_MAX; ++i) wr_s16b(player->stat_max[i]);
-	for (i = 0; i < STAT_MAX; ++i) wr_s16b(player->stat_cur[i]);
-	for (i = 0; i < STAT_MAX; ++i) wr_s16b(player->stat_map[i]);
-	for (i = 0; i < STAT_MAX; ++i) wr_s16b(player->stat_birth[i]);
+	wr_s16b_array(player->stat_max, STAT_MAX);
+	wr_s16b_array(player->stat_cur, STAT_MAX);
+	wr_s16b_array(player->stat_map, STAT_MAX);
+	wr_s16b_array(player->stat_birth, STAT_MAX);
 
 	wr_s16b(player->ht_birth);
 	wr_s16b(player->wt_birth);
@@ -481,8 +474,7 @@ void wr_player(void)
 	wr_byte(TMD_MAX);
 
 	/* Read all the effects, in a loop */
-	for (i = 0; i < TMD_MAX; i++)
-		wr_s16b(player->timed[i]);
+	wr_s16b_array(player->timed, TMD_MAX);
 
 	/* Total energy used so far */
 	wr_u32b(player->total_energy);
@@ -500,8 +492,7 @@ void wr_ignore(void)
 
 	/* Write number of ignore bytes */
 	wr_byte(ignore_size);
-	for (i = 0; i < ignore_size; i++)
-		wr_byte(ignore_level[i]);
+	wr_bytes(ignore_level, ignore_size);
 
 	/* Write ego-item ignore bits */
 	wr_u16b(z_info->e_max);
@@ -610,8 +601,7 @@ void wr_misc(void)
 	//	return;
 
 	/* Flags */
-	for (i = 0; i < OF_SIZE; i++)
-		wr_byte(player->obj_k->flags[i]);
+	wr_bytes(player->obj_k->flags, OF_SIZE);
 
 	/* Modifiers */
 	for (i = 0; i < OBJ_MOD_MAX; i++) {
@@ -669,25 +659,17 @@ void wr_artifacts(void)
 
 void wr_player_hp(void)
 {
-	int i;
-
 	wr_u16b(PY_MAX_LEVEL);
-	for (i = 0; i < PY_MAX_LEVEL; i++)
-		wr_s16b(player->player_hp[i]);
+	wr_s16b_array(player->player_hp, PY_MAX_LEVEL);
 }
 
 
 void wr_player_spells(void)
 {
-	int i;
-
 	wr_u16b(player->class->magic.total_spells);
 
-	for (i = 0; i < player->class->magic.total_spells; i++)
-		wr_byte(player->spell_flags[i]);
-
-	for (i = 0; i < player->class->magic.total_spells; i++)
-		wr_byte(player->spell_order[i]);
+	wr_bytes(player->spell_flags, player->class->magic.total_spells);
+	wr_bytes(player->spell_order, player->class->magic.total_spells);
 }
 
 static void wr_gear_aux(struct object *gear)
@@ -747,7 +729,7 @@ void wr_stores(void)
 /**
  * Write the current dungeon terrain features and info flags
  *
- * Note that the cost and when fields of c->squares[y][x] are not saved
+ * Note that the noise and scent heatmaps of c are not saved
  */
 static void wr_dungeon_aux(struct chunk *c)
 {
@@ -764,7 +746,7 @@ static void wr_dungeon_aux(struct chunk *c)
 	wr_u16b(c->height);
 	wr_u16b(c->width);
 
-	/* Run length encoding of c->squares[y][x].info */
+	/* Run length encoding of c->info[y][x] */
 	for (i = 0; i < SQUARE_SIZE; i++) {
 		count = 0;
 		prev_char = 0;
@@ -772,8 +754,8 @@ static void wr_dungeon_aux(struct chunk *c)
 		/* Dump for each grid */
 		for (y = 0; y < c->height; y++) {
 			for (x = 0; x < c->width; x++) {
-				/* Extract the important c->squares[y][x].info flags */
-				tmp8u = c->squares[y][x].info[i];
+				/* Extract the important c->info[y][x] flags */
+				tmp8u = c->info[y][x][i];
 
 				/* If the run is broken, or too full, flush it */
 				if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
@@ -801,7 +783,7 @@ static void wr_dungeon_aux(struct chunk *c)
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
 			/* Extract a byte */
-			tmp8u = c->squares[y][x].feat;
+			tmp8u = c->feat[y][x];
 
 			/* If the run is broken, or too full, flush it */
 			if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
@@ -834,14 +816,11 @@ static void wr_objects_aux(struct chunk *c)
 	int y, x, i;
 	struct object *dummy;
 
-	if (player->is_dead)
-		return;
-	
 	/* Write the objects */
 	wr_u16b(c->obj_max);
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
-			struct object *obj = c->squares[y][x].obj;
+			struct object *obj = c->obj[y][x];
 			while (obj) {
 				wr_item(obj);
 				obj = obj->next;
@@ -863,9 +842,9 @@ static void wr_objects_aux(struct chunk *c)
 	}
 
 	/* Write a dummy record as a marker */
-	dummy = mem_zalloc(sizeof(*dummy));
+	dummy = object_new();
 	wr_item(dummy);
-	mem_free(dummy);
+	object_free(dummy);
 }
 
 /**
@@ -875,16 +854,14 @@ static void wr_monsters_aux(struct chunk *c)
 {
 	int i;
 
-	if (player->is_dead)
-		return;
-
 	/* Total monsters */
 	wr_u16b(cave_monster_max(c));
 
 	/* Dump the monsters */
 	for (i = 1; i < cave_monster_max(c); i++) {
-		const struct monster *mon = cave_monster(c, i);
+		struct monster *mon = cave_monster(c, i);
 
+		monster_energy_settle(c, mon);
 		wr_monster(mon);
 	}
 }
@@ -894,14 +871,11 @@ static void wr_traps_aux(struct chunk *c)
     int x, y;
 	struct trap *dummy;
 
-    if (player->is_dead)
-		return;
-
     wr_byte(TRF_SIZE);
 
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
-			struct trap *trap = c->squares[y][x].trap;
+			struct trap *trap = c->trap[y][x];
 			while (trap) {
 				wr_trap(trap);
 				trap = trap->next;
@@ -938,49 +912,68 @@ void wr_dungeon(void)
 
 void wr_objects(void)
 {
+	if (player->is_dead)
+		return;
+
 	wr_objects_aux(cave);
 	wr_objects_aux(player->cave);
 }
 
 void wr_monsters(void)
 {
+	if (player->is_dead)
+		return;
+
 	wr_monsters_aux(cave);
 	wr_monsters_aux(player->cave);
 }
 
 void wr_traps(void)
 {
+	if (player->is_dead)
+		return;
+
 	wr_traps_aux(cave);
 	wr_traps_aux(player->cave);
 }
 
-/*
- * Write the chunk list
+/**
+ * Write one chunk, noting how many bytes the terrain took
  */
-void wr_chunks(void)
+void wr_chunk(struct chunk *c, u32b *terrain_len)
 {
-	int j;
+	u32b start = sf_pos();
 
-	//if (player->is_dead)
-	//	return;
+	/* Write the terrain and info */
+	wr_dungeon_aux(c);
+	*terrain_len = sf_pos() - start;
 
-	wr_u16b(chunk_list_max);
+	/* Write the objects */
+	wr_objects_aux(c);
 
-	/* Now write each chunk */
-	for (j = 0; j < chunk_list_max; j++) {
-		struct chunk *c = chunk_list[j];
+	/* Write the monsters */
+	wr_monsters_aux(c);
 
-		/* Write the terrain and info */
-		wr_dungeon_aux(c);
+	/* Write the traps */
+	wr_traps_aux(c);
+}
+
+/*
+ * Write the chunk list
+ */
+void wr_chunks(void)
+{
+	struct stored_chunk *s;
 
-		/* Write the objects */
-		wr_objects_aux(c);
+	wr_u16b(chunk_list_max);
 
-		/* Write the monsters */
-		wr_monsters_aux(c);
+	/* Now write each chunk, as it was encoded when stored; only the terrain
+	 * is kept for dead characters */
+	for (s = chunk_list; s; s = s->next) {
+		byte *data = chunk_list_encoding(s);
 
-		/* Write the traps */
-		wr_traps_aux(c);
+		wr_bytes(data, player->is_dead ? s->terrain_len : s->raw_len);
+		mem_free(data);
 	}
 }
 
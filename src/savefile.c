@@ -20,6 +20,16 @@
 #include "game-world.h"
 #include "init.h"
 #include "savefile.h"
+#include "z-lz.h"
+
+/**
+ * Background saves need a second thread, and the allocation profiler is not
+ * safe to call from one.
+ */
+#if defined(HAVE_PTHREAD_H) && !defined(MEM_PROFILE)
+# define SAVE_IN_BACKGROUND
+# include <pthread.h>
+#endif
 
 /**
  * The savefile code.
@@ -84,8 +94,11 @@ typedef int (*loader_t)(void);
 
 struct blockheader {
 	char name[16];
+	byte encoding;
 	u32b version;
-	u32b size;
+	u32b length;	/* Bytes of data as stored */
+	u32b check;
+	u32b size;		/* Bytes of data as stored, padded */
 };
 
 struct blockinfo {
@@ -160,10 +173,23 @@ static u32b buffer_pos;
 static u32b buffer_check;
 
 #define BUFFER_INITIAL_SIZE		1024
-#define BUFFER_BLOCK_INCREMENT	1024
 
 #define SAVEFILE_HEAD_SIZE		28
 
+/**
+ * How the data in a block is stored, given by the last byte of the block
+ * name (block names are never that long).  A compressed block starts with
+ * its length when uncompressed, followed by the data as compressed by
+ * lz_compress().  Only blocks of at least BLOCK_COMPRESS_MIN bytes are
+ * compressed, and only when that makes them smaller.
+ */
+enum {
+	BLOCK_RAW = 0,
+	BLOCK_LZ = 1
+};
+
+#define BLOCK_COMPRESS_MIN		64
+
 
 /**
  * ------------------------------------------------------------------------
@@ -185,21 +211,48 @@ void note(const char *message)
  * Base put/get
  * ------------------------------------------------------------------------ */
 
-static void sf_put(byte v)
+/**
+ * Make room for another `n` bytes in the save buffer, doubling it as often
+ * as needed so that a block of any size takes few reallocations
+ */
+static void sf_reserve(size_t n)
 {
 	assert(buffer != NULL);
 	assert(buffer_size > 0);
 
-	if (buffer_size == buffer_pos)
-	{
-		buffer_size += BUFFER_BLOCK_INCREMENT;
-		buffer = mem_realloc(buffer, buffer_size);
-	}
-
-	assert(buffer_pos < buffer_size);
+	if (buffer_pos + n <= buffer_size) return;
+	while (buffer_pos + n > buffer_size)
+		buffer_size *= 2;
+	buffer = mem_realloc(buffer, buffer_size);
+}
 
-	buffer[buffer_pos++] = v;
-	buffer_check += v;
+/**
+ * Add up the bytes of a block.  When saving, the checksum is done once per
+ * block rather than as each byte goes in, eight bytes at a time in four
+ * 16-bit lanes which are folded together before they can overflow.
+ */
+static u32b sf_checksum(const byte *data, u32b len)
+{
+	const u64b mask = 0x00FF00FF00FF00FFULL;
+	u32b check = 0;
+	u32b i = 0;
+
+	while (len - i >= 8) {
+		u32b words = MIN((len - i) / 8, 128);
+		u64b lanes = 0;
+
+		while (words--) {
+			u64b w;
+			memcpy(&w, data + i, 8);
+			lanes += (w & mask) + ((w >> 8) & mask);
+			i += 8;
+		}
+		check += (u32b)((lanes & 0xFFFF) + ((lanes >> 16) & 0xFFFF) +
+						((lanes >> 32) & 0xFFFF) + (lanes >> 48));
+	}
+	while (i < len)
+		check += data[i++];
+	return check;
 }
 
 static byte sf_get(void)
@@ -220,13 +273,15 @@ static byte sf_get(void)
 
 void wr_byte(byte v)
 {
-	sf_put(v);
+	sf_reserve(1);
+	buffer[buffer_pos++] = v;
 }
 
 void wr_u16b(u16b v)
 {
-	sf_put((byte)(v & 0xFF));
-	sf_put((byte)((v >> 8) & 0xFF));
+	sf_reserve(2);
+	buffer[buffer_pos++] = (byte)(v & 0xFF);
+	buffer[buffer_pos++] = (byte)((v >> 8) & 0xFF);
 }
 
 void wr_s16b(s16b v)
@@ -236,10 +291,11 @@ void wr_s16b(s16b v)
 
 void wr_u32b(u32b v)
 {
-	sf_put((byte)(v & 0xFF));
-	sf_put((byte)((v >> 8) & 0xFF));
-	sf_put((byte)((v >> 16) & 0xFF));
-	sf_put((byte)((v >> 24) & 0xFF));
+	sf_reserve(4);
+	buffer[buffer_pos++] = (byte)(v & 0xFF);
+	buffer[buffer_pos++] = (byte)((v >> 8) & 0xFF);
+	buffer[buffer_pos++] = (byte)((v >> 16) & 0xFF);
+	buffer[buffer_pos++] = (byte)((v >> 24) & 0xFF);
 }
 
 void wr_s32b(s32b v)
@@ -247,16 +303,39 @@ void wr_s32b(s32b v)
 	wr_u32b((u32b)v);
 }
 
-void wr_string(const char *str)
+u32b sf_pos(void)
 {
-	while (*str)
-	{
-		wr_byte(*str);
-		str++;
+	return buffer_pos;
+}
+
+void wr_bytes(const byte *v, size_t n)
+{
+	sf_reserve(n);
+	memcpy(buffer + buffer_pos, v, n);
+	buffer_pos += n;
+}
+
+void wr_u16b_array(const u16b *v, size_t n)
+{
+	size_t i;
+
+	sf_reserve(2 * n);
+	for (i = 0; i < n; i++) {
+		buffer[buffer_pos++] = (byte)(v[i] & 0xFF);
+		buffer[buffer_pos++] = (byte)((v[i] >> 8) & 0xFF);
 	}
-	wr_byte(*str);
 }
 
+void wr_s16b_array(const s16b *v, size_t n)
+{
+	wr_u16b_array((const u16b *)v, n);
+}
+
+void wr_string(const char *str)
+{
+	/* Include the terminator */
+	wr_bytes((const byte *)str, strlen(str) + 1);
+}
 
 void rd_byte(byte *ip)
 {
@@ -310,7 +389,10 @@ void strip_bytes(int n)
 
 void pad_bytes(int n)
 {
-	while (n--) wr_byte(0);
+	if (n <= 0) return;
+	sf_reserve(n);
+	memset(buffer + buffer_pos, 0, n);
+	buffer_pos += n;
 }
 
 
@@ -319,10 +401,53 @@ void pad_bytes(int n)
  * Savefile saving functions
  * ------------------------------------------------------------------------ */
 
+/**
+ * A whole savefile, built in memory before any of it goes to disk
+ */
+struct save_image {
+	byte *data;
+	size_t len;
+	size_t size;
+};
+
+/**
+ * A savefile waiting to be written, and the names used to swap it into place
+ */
+struct save_job {
+	struct save_image image;
+	ang_file *file;
+	char path[1024];
+	char new_savefile[1024];
+	char old_savefile[1024];
+	bool ok;
+};
+
+/**
+ * The background save still being written, if any
+ */
+static struct save_job *pending_job;
+
+#ifdef SAVE_IN_BACKGROUND
+static pthread_t save_thread;
+#endif
+
+static void image_append(struct save_image *image, const void *data,
+						 size_t n)
+{
+	if (image->size - image->len < n) {
+		while (image->size - image->len < n)
+			image->size *= 2;
+		image->data = mem_realloc(image->data, image->size);
+	}
+	memcpy(image->data + image->len, data, n);
+	image->len += n;
+}
 
-static bool try_save(ang_file *file)
+static void try_save(struct save_image *image)
 {
 	byte savefile_head[SAVEFILE_HEAD_SIZE];
+	byte *packed = NULL;
+	u32b packed_size = 0;
 	size_t i, pos;
 
 	/* Start off the buffer */
@@ -330,17 +455,45 @@ static bool try_save(ang_file *file)
 	buffer_size = BUFFER_INITIAL_SIZE;
 
 	for (i = 0; i < N_ELEMENTS(savers); i++) {
+		byte encoding = BLOCK_RAW;
+		byte *data;
+		u32b length;
+
 		buffer_pos = 0;
-		buffer_check = 0;
 
 		savers[i].save();
+		buffer_check = sf_checksum(buffer, buffer_pos);
+		data = buffer;
+		length = buffer_pos;
+
+		/* Compress the block if that makes it smaller */
+		if (buffer_pos >= BLOCK_COMPRESS_MIN) {
+			size_t n;
+
+			if (packed_size < buffer_pos) {
+				packed_size = buffer_pos;
+				packed = mem_realloc(packed, packed_size);
+			}
+			n = lz_compress(buffer, buffer_pos, packed + 4, buffer_pos - 5);
+			if (n) {
+				packed[0] = (buffer_pos & 0xFF);
+				packed[1] = ((buffer_pos >> 8) & 0xFF);
+				packed[2] = ((buffer_pos >> 16) & 0xFF);
+				packed[3] = ((buffer_pos >> 24) & 0xFF);
+				encoding = BLOCK_LZ;
+				data = packed;
+				length = n + 4;
+			}
+		}
 
-		/* 16-byte block name */
+		/* 16-byte block name, ending with the encoding */
+		assert(strlen(savers[i].name) < 15);
 		pos = my_strcpy((char *)savefile_head,
 				savers[i].name,
 				sizeof savefile_head);
 		while (pos < 16)
 			savefile_head[pos++] = 0;
+		savefile_head[15] = encoding;
 
 #define SAVE_U32B(v)	\
 		savefile_head[pos++] = (v & 0xFF); \
@@ -349,94 +502,196 @@ static bool try_save(ang_file *file)
 		savefile_head[pos++] = ((v >> 24) & 0xFF);
 
 		SAVE_U32B(savers[i].version);
-		SAVE_U32B(buffer_pos);
+		SAVE_U32B(length);
 		SAVE_U32B(buffer_check);
 
 		assert(pos == SAVEFILE_HEAD_SIZE);
 
-		file_write(file, (char *)savefile_head, SAVEFILE_HEAD_SIZE);
-		file_write(file, (char *)buffer, buffer_pos);
+		image_append(image, savefile_head, SAVEFILE_HEAD_SIZE);
+		image_append(image, data, length);
 
 		/* pad to 4 byte multiples */
-		if (buffer_pos % 4)
-			file_write(file, "xxx", 4 - (buffer_pos % 4));
+		if (length % 4)
+			image_append(image, "xxx", 4 - (length % 4));
 	}
 
+	mem_free(packed);
 	mem_free(buffer);
-
-	return true;
 }
 
 /**
- * Attempt to save the player in a savefile
+ * Snapshot the game into a new save job for `path`, and open the file it
+ * will be written to.
+ *
+ * This is the only part of saving that looks at the game state, so it must
+ * happen on the game thread; the job can then be written out from anywhere.
+ * The new savefile is opened here too, so that a worker writing the job never
+ * needs privileges to do it.
  */
-bool savefile_save(const char *path)
+static struct save_job *save_job_new(const char *path)
 {
-	ang_file *file;
+	struct save_job *job = mem_zalloc(sizeof(*job));
 	int count = 0;
-	char new_savefile[1024];
-	char old_savefile[1024];
+
+	my_strcpy(job->path, path, sizeof(job->path));
 
 	/* New savefile */
-	strnfmt(old_savefile, sizeof(old_savefile), "%s%u.old", path,
+	strnfmt(job->old_savefile, sizeof(job->old_savefile), "%s%u.old", path,
 			Rand_simple(1000000));
-	while (file_exists(old_savefile) && (count++ < 100))
-		strnfmt(old_savefile, sizeof(old_savefile), "%s%u%u.old", path,
-				Rand_simple(1000000),count);
+	while (file_exists(job->old_savefile) && (count++ < 100))
+		strnfmt(job->old_savefile, sizeof(job->old_savefile), "%s%u%u.old",
+				path, Rand_simple(1000000),count);
 
 	count = 0;
 
-	/* Open the savefile */
 	safe_setuid_grab();
-	strnfmt(new_savefile, sizeof(new_savefile), "%s%u.new", path,
+	strnfmt(job->new_savefile, sizeof(job->new_savefile), "%s%u.new", path,
 			Rand_simple(1000000));
-	while (file_exists(new_savefile) && (count++ < 100))
-		strnfmt(new_savefile, sizeof(new_savefile), "%s%u%u.new", path,
-				Rand_simple(1000000),count);
+	while (file_exists(job->new_savefile) && (count++ < 100))
+		strnfmt(job->new_savefile, sizeof(job->new_savefile), "%s%u%u.new",
+				path, Rand_simple(1000000),count);
 
-	file = file_open(new_savefile, MODE_WRITE, FTYPE_SAVE);
+	/* Open the savefile */
+	job->file = file_open(job->new_savefile, MODE_WRITE, FTYPE_SAVE);
 	safe_setuid_drop();
 
-	if (file) {
-		file_write(file, (char *) &savefile_magic, 4);
-		file_write(file, (char *) &savefile_name, 4);
+	if (!job->file)
+		return job;
 
-		character_saved = try_save(file);
-		file_close(file);
-	}
+	/* Build the file */
+	job->image.size = 64 * 1024;
+	job->image.data = mem_alloc(job->image.size);
+	image_append(&job->image, savefile_magic, 4);
+	image_append(&job->image, savefile_name, 4);
+	try_save(&job->image);
 
-	if (character_saved) {
-		bool err = false;
+	return job;
+}
 
-		safe_setuid_grab();
+static void save_job_free(struct save_job *job)
+{
+	mem_free(job->image.data);
+	mem_free(job);
+}
 
-		if (file_exists(path) && !file_move(path, old_savefile))
-			err = true;
+/**
+ * Write out a save job, and swap it in for the old savefile.
+ *
+ * This touches nothing but the job and the filesystem, so it is safe to run
+ * on a second thread.  The swap needs privileges, and grabbing them waits for
+ * the game thread to be done with them, so it must not hold them meanwhile.
+ */
+static bool save_job_write(struct save_job *job)
+{
+	bool written, err = false;
 
-		if (!err) {
-			if (!file_move(new_savefile, path))
-				err = true;
+	if (!job->file)
+		return false;
 
-			if (err)
-				file_move(old_savefile, path);
-			else
-				file_delete(old_savefile);
-		} 
+	written = file_write(job->file, (char *) job->image.data,
+						 job->image.len) && file_sync(job->file);
+	if (!file_close(job->file))
+		written = false;
+	job->file = NULL;
 
-		safe_setuid_drop();
+	safe_setuid_grab();
 
-		return err ? false : true;
+	if (!written) {
+		/* Delete temp file if the save failed */
+		file_delete(job->new_savefile);
+		err = true;
+	} else if (file_exists(job->path) &&
+			   !file_move(job->path, job->old_savefile)) {
+		err = true;
+	} else if (!file_move(job->new_savefile, job->path)) {
+		file_move(job->old_savefile, job->path);
+		err = true;
+	} else {
+		file_delete(job->old_savefile);
 	}
 
-	/* Delete temp file if the save failed */
-	if (file) {
-		/* File is no longer valid, but it still points to a non zero
-		 * value if the file was created above */
-		safe_setuid_grab();
-		file_delete(new_savefile);
-		safe_setuid_drop();
+	safe_setuid_drop();
+
+	return !err;
+}
+
+#ifdef SAVE_IN_BACKGROUND
+static void *save_thread_main(void *arg)
+{
+	struct save_job *job = arg;
+
+	job->ok = save_job_write(job);
+	return NULL;
+}
+#endif
+
+/**
+ * Wait for any background save to finish
+ */
+bool savefile_wait(void)
+{
+	bool ok;
+
+	if (!pending_job)
+		return true;
+
+#ifdef SAVE_IN_BACKGROUND
+	pthread_join(save_thread, NULL);
+#endif
+
+	ok = pending_job->ok;
+	save_job_free(pending_job);
+	pending_job = NULL;
+
+	if (!ok)
+		character_saved = false;
+
+	return ok;
+}
+
+/**
+ * Attempt to save the player in a savefile
+ */
+bool savefile_save(const char *path)
+{
+	struct save_job *job;
+	bool ok;
+
+	/* Don't race a background save of the same file */
+	savefile_wait();
+
+	job = save_job_new(path);
+	ok = save_job_write(job);
+	save_job_free(job);
+
+	character_saved = ok;
+	return ok;
+}
+
+/**
+ * Snapshot the player now, and write the savefile on a second thread
+ */
+bool savefile_save_background(const char *path)
+{
+	struct save_job *job;
+	bool ok = savefile_wait();
+
+	job = save_job_new(path);
+	character_saved = true;
+
+#ifdef SAVE_IN_BACKGROUND
+	if (pthread_create(&save_thread, NULL, save_thread_main, job) == 0) {
+		pending_job = job;
+		return ok;
 	}
-	return false;
+#endif
+
+	/* No second thread, so write it now */
+	if (!save_job_write(job))
+		ok = character_saved = false;
+	save_job_free(job);
+
+	return ok;
 }
 
 
@@ -471,7 +726,7 @@ static errr next_blockheader(ang_file *f, struct blockheader *b) {
 	if (len == 0) /* no more blocks */
 		return 1;
 
-	if (len != SAVEFILE_HEAD_SIZE || savefile_head[15] != 0) {
+	if (len != SAVEFILE_HEAD_SIZE || savefile_head[15] > BLOCK_LZ) {
 		return -1;
 	}
 
@@ -482,8 +737,11 @@ static errr next_blockheader(ang_file *f, struct blockheader *b) {
 	((u32b) savefile_head[from+3] << 24);
 
 	my_strcpy(b->name, (char *)&savefile_head, sizeof b->name);
+	b->encoding = savefile_head[15];
 	b->version = RECONSTRUCT_U32B(16);
-	b->size = RECONSTRUCT_U32B(20);
+	b->length = RECONSTRUCT_U32B(20);
+	b->check = RECONSTRUCT_U32B(24);
+	b->size = b->length;
 
 	/* Pad to 4 bytes */
 	if (b->size % 4)
@@ -511,19 +769,58 @@ static loader_t find_loader(struct blockheader *b,
 	return NULL;
 }
 
+/**
+ * Read a compressed block into the buffer, uncompressed, checking it against
+ * the checksum in its header
+ */
+static bool unpack_block(ang_file *f, struct blockheader *b)
+{
+	byte *packed = mem_alloc(b->size);
+	bool ok = false;
+
+	if (file_read(f, (char *) packed, b->size) == (int) b->size &&
+			b->length >= 4) {
+		buffer_size = ((u32b) packed[0]) | ((u32b) packed[1] << 8) |
+			((u32b) packed[2] << 16) | ((u32b) packed[3] << 24);
+
+		/* No copy makes more than 255 bytes for each byte it takes up */
+		if (buffer_size / 256 <= b->length) {
+			buffer = mem_alloc(buffer_size);
+			ok = buffer && lz_decompress(packed + 4, b->length - 4, buffer,
+										 buffer_size) &&
+				sf_checksum(buffer, buffer_size) == b->check;
+		}
+	}
+
+	mem_free(packed);
+	return ok;
+}
+
 /**
  * Load a given block with the given loader
  */
 static bool load_block(ang_file *f, struct blockheader *b, loader_t loader)
 {
-	/* Allocate space for the buffer */
-	buffer = mem_alloc(b->size);
+	buffer = NULL;
 	buffer_pos = 0;
 	buffer_check = 0;
 
-	buffer_size = file_read(f, (char *) buffer, b->size);
-	if (buffer_size != b->size ||
-			loader() != 0) {
+	if (b->encoding == BLOCK_LZ) {
+		if (!unpack_block(f, b)) {
+			mem_free(buffer);
+			return false;
+		}
+	} else {
+		/* Allocate space for the buffer */
+		buffer = mem_alloc(b->size);
+		buffer_size = file_read(f, (char *) buffer, b->size);
+		if (buffer_size != b->size) {
+			mem_free(buffer);
+			return false;
+		}
+	}
+
+	if (loader() != 0) {
 		mem_free(buffer);
 		return false;
 	}
@@ -589,8 +886,10 @@ static int get_desc(void) {
  */
 const char *savefile_get_description(const char *path) {
 	struct blockheader b;
+	ang_file *f;
 
-	ang_file *f = file_open(path, MODE_READ, FTYPE_TEXT);
+	savefile_wait();
+	f = file_open(path, MODE_READ, FTYPE_TEXT);
 	if (!f) return NULL;
 
 	/* Blank the description */
@@ -620,7 +919,10 @@ const char *savefile_get_description(const char *path) {
 bool savefile_load(const char *path, bool cheat_death)
 {
 	bool ok;
-	ang_file *f = file_open(path, MODE_READ, FTYPE_TEXT);
+	ang_file *f;
+
+	savefile_wait();
+	f = file_open(path, MODE_READ, FTYPE_TEXT);
 	if (!f) {
 		note("Couldn't open savefile.");
 		return false;
@@ -645,3 +947,77 @@ bool savefile_load(const char *path, bool cheat_death)
 
 	return ok;
 }
+
+
+/**
+ * ------------------------------------------------------------------------
+ * Stored chunks
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Buffer state put aside while a stored chunk is encoded or decoded, which
+ * can happen in the middle of a save or load
+ */
+struct sf_buffer {
+	byte *buffer;
+	u32b size;
+	u32b pos;
+	u32b check;
+};
+
+static void sf_buffer_swap(struct sf_buffer *keep, byte *data, u32b size)
+{
+	keep->buffer = buffer;
+	keep->size = buffer_size;
+	keep->pos = buffer_pos;
+	keep->check = buffer_check;
+
+	buffer = data;
+	buffer_size = size;
+	buffer_pos = 0;
+	buffer_check = 0;
+}
+
+static void sf_buffer_restore(const struct sf_buffer *keep)
+{
+	buffer = keep->buffer;
+	buffer_size = keep->size;
+	buffer_pos = keep->pos;
+	buffer_check = keep->check;
+}
+
+/**
+ * Encode a chunk the way the savefile stores it
+ */
+byte *savefile_encode_chunk(struct chunk *c, u32b *len, u32b *terrain_len)
+{
+	struct sf_buffer keep;
+	byte *data;
+
+	sf_buffer_swap(&keep, mem_alloc(BUFFER_INITIAL_SIZE), BUFFER_INITIAL_SIZE);
+	wr_chunk(c, terrain_len);
+	data = buffer;
+	*len = buffer_pos;
+	sf_buffer_restore(&keep);
+
+	return data;
+}
+
+/**
+ * Rebuild a chunk from savefile_encode_chunk()
+ */
+struct chunk *savefile_decode_chunk(const byte *data, u32b len)
+{
+	struct sf_buffer keep;
+	struct chunk *c = NULL;
+
+	sf_buffer_swap(&keep, (byte *) data, len);
+	if (rd_chunk(&c) || buffer_pos != len) {
+		if (c)
+			cave_free(c);
+		c = NULL;
+	}
+	sf_buffer_restore(&keep);
+
+	return c;
+}
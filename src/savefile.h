@@ -37,6 +37,19 @@ extern bool character_saved;
  */
 bool savefile_save(const char *path);
 
+/**
+ * Save to the given location, writing the file out in the background where
+ * the platform allows.  The game state is captured before this returns.
+ * Returns false if this save could not be started, or the previous
+ * background save failed.
+ */
+bool savefile_save_background(const char *path);
+
+/**
+ * Wait for a background save to finish.  Returns false if it failed.
+ */
+bool savefile_wait(void);
+
 /**
  * Load the savefile given.  Returns true on succcess, false otherwise.
  */
@@ -47,6 +60,17 @@ bool savefile_load(const char *path, bool cheat_death);
  */
 const char *savefile_get_description(const char *path);
 
+/**
+ * Encode a chunk the way the savefile stores it, for keeping in memory.
+ * Returns the encoding, which the caller frees, and its length.
+ */
+byte *savefile_encode_chunk(struct chunk *c, u32b *len, u32b *terrain_len);
+
+/**
+ * Rebuild a chunk from savefile_encode_chunk(), or NULL if it won't decode.
+ */
+struct chunk *savefile_decode_chunk(const byte *data, u32b len);
+
 
 /**
  * ------------------------------------------------------------------------
@@ -63,9 +87,15 @@ void wr_u16b(u16b v);
 void wr_s16b(s16b v);
 void wr_u32b(u32b v);
 void wr_s32b(s32b v);
+void wr_bytes(const byte *v, size_t n);
+void wr_u16b_array(const u16b *v, size_t n);
+void wr_s16b_array(const s16b *v, size_t n);
 void wr_string(const char *str);
 void pad_bytes(int n);
 
+/* Position in the block being read or written */
+u32b sf_pos(void);
+
 /* Reading bits */
 void rd_byte(byte *ip);
 void rd_u16b(u16b *ip);
@@ -93,6 +123,7 @@ int rd_player_spells(void);
 int rd_gear(void);
 int rd_stores(void);
 int rd_dungeon(void);
+int rd_chunk(struct chunk **c);
 int rd_chunks(void);
 int rd_objects(void);
 int rd_monsters(void);
@@ -118,6 +149,7 @@ void wr_randarts(void);
 void wr_gear(void);
 void wr_stores(void);
 void wr_dungeon(void);
+void wr_chunk(struct chunk *c, u32b *terrain_len);
 void wr_chunks(void);
 void wr_objects(void);
 void wr_monsters(void);
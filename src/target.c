@@ -319,13 +319,13 @@ bool target_accept(int y, int x)
 	struct object *obj;
 
 	/* Player grids are always interesting */
-	if (cave->squares[y][x].mon < 0) return (true);
+	if (cave->mon[y][x] < 0) return (true);
 
 	/* Handle hallucination */
 	if (player->timed[TMD_IMAGE]) return (false);
 
 	/* Obvious monsters */
-	if (cave->squares[y][x].mon > 0) {
+	if (cave->mon[y][x] > 0) {
 		struct monster *mon = square_monster(cave, y, x);
 		if (monster_is_obvious(mon))
 			return (true);
@@ -436,7 +436,7 @@ struct point_set *target_get_monsters(int mode)
 			/* Special mode */
 			if (mode & (TARGET_KILL)) {
 				/* Must contain a monster */
-				if (!(cave->squares[y][x].mon > 0)) continue;
+				if (!(cave->mon[y][x] > 0)) continue;
 
 				/* Must be a targettable monster */
 			 	if (!target_able(square_monster(cave, y, x))) continue;
@@ -0,0 +1,281 @@
+/* cave/los */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "player.h"
+
+/**
+ * The line of sight walk los() used before it had precomputed rays, which
+ * los() must still agree with exactly.
+ */
+static bool los_reference(struct chunk *c, int y1, int x1, int y2, int x2)
+{
+	/* Delta */
+	int dx, dy;
+
+	/* Absolute */
+	int ax, ay;
+
+	/* Signs */
+	int sx, sy;
+
+	/* Fractions */
+	int qx, qy;
+
+	/* Scanners */
+	int tx, ty;
+
+	/* Scale factors */
+	int f1, f2;
+
+	/* Slope, or 1/Slope, of LOS */
+	int m;
+
+
+	/* Extract the offset */
+	dy = y2 - y1;
+	dx = x2 - x1;
+
+	/* Extract the absolute offset */
+	ay = ABS(dy);
+	ax = ABS(dx);
+
+
+	/* Handle adjacent (or identical) grids */
+	if ((ax < 2) && (ay < 2)) return (true);
+
+
+	/* Directly South/North */
+	if (!dx) {
+		/* South -- check for walls */
+		if (dy > 0) {
+			for (ty = y1 + 1; ty < y2; ty++)
+				if (!square_isprojectable(c, ty, x1)) return (false);
+		} else { /* North -- check for walls */
+			for (ty = y1 - 1; ty > y2; ty--)
+				if (!square_isprojectable(c, ty, x1)) return (false);
+		}
+
+		/* Assume los */
+		return (true);
+	}
+
+	/* Directly East/West */
+	if (!dy) {
+		/* East -- check for walls */
+		if (dx > 0) {
+			for (tx = x1 + 1; tx < x2; tx++)
+				if (!square_isprojectable(c, y1, tx)) return (false);
+		} else { /* West -- check for walls */
+			for (tx = x1 - 1; tx > x2; tx--)
+				if (!square_isprojectable(c, y1, tx)) return (false);
+		}
+
+		/* Assume los */
+		return (true);
+	}
+
+
+	/* Extract some signs */
+	sx = (dx < 0) ? -1 : 1;
+	sy = (dy < 0) ? -1 : 1;
+
+	/* Vertical "knights" */
+	if ((ax == 1) && (ay == 2) && square_isprojectable(c, y1 + sy, x1))
+		return (true);
+	
+	/* Horizontal "knights" */
+	else if ((ay == 1) && (ax == 2) && square_isprojectable(c, y1, x1 + sx))
+		return (true);
+
+	/* Calculate scale factor div 2 */
+	f2 = (ax * ay);
+
+	/* Calculate scale factor */
+	f1 = f2 << 1;
+
+
+	/* Travel horizontally */
+	if (ax >= ay) {
+		/* Let m = dy / dx * 2 * (dy * dx) = 2 * dy * dy */
+		qy = ay * ay;
+		m = qy << 1;
+
+		tx = x1 + sx;
+
+		/* Consider the special case where slope == 1. */
+		if (qy == f2) {
+			ty = y1 + sy;
+			qy -= f1;
+		} else {
+			ty = y1;
+		}
+
+		/* Note (below) the case (qy == f2), where */
+		/* the LOS exactly meets the corner of a tile. */
+		while (x2 - tx) {
+			if (!square_isprojectable(c, ty, tx))
+				return (false);
+
+			qy += m;
+
+			if (qy < f2) {
+				tx += sx;
+			} else if (qy > f2) {
+				ty += sy;
+				if (!square_isprojectable(c, ty, tx))
+					return (false);
+				qy -= f1;
+				tx += sx;
+			} else {
+				ty += sy;
+				qy -= f1;
+				tx += sx;
+			}
+		}
+	} else { /* Travel vertically */
+		/* Let m = dx / dy * 2 * (dx * dy) = 2 * dx * dx */
+		qx = ax * ax;
+		m = qx << 1;
+
+		ty = y1 + sy;
+
+		if (qx == f2) {
+			tx = x1 + sx;
+			qx -= f1;
+		} else {
+			tx = x1;
+		}
+
+		/* Note (below) the case (qx == f2), where */
+		/* the LOS exactly meets the corner of a tile. */
+		while (y2 - ty) {
+			if (!square_isprojectable(c, ty, tx))
+				return (false);
+
+			qx += m;
+
+			if (qx < f2) {
+				ty += sy;
+			} else if (qx > f2) {
+				tx += sx;
+				if (!square_isprojectable(c, ty, tx))
+					return (false);
+				qx -= f1;
+				ty += sy;
+			} else {
+				tx += sx;
+				qx -= f1;
+				ty += sy;
+			}
+		}
+	}
+
+	/* Assume los */
+	return (true);
+}
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+
+	/* Set up a character so levels can be generated */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Compare los() with the reference from a sample of grids to every grid
+ * within a little over max_sight of them
+ */
+static bool los_matches(struct chunk *c, int step) {
+	int y1, x1, y2, x2;
+	int r = z_info->max_sight + 2;
+
+	for (y1 = 1; y1 < c->height - 1; y1 += step) {
+		for (x1 = 1; x1 < c->width - 1; x1 += step) {
+			for (y2 = MAX(y1 - r, 0); y2 <= MIN(y1 + r, c->height - 1); y2++) {
+				for (x2 = MAX(x1 - r, 0); x2 <= MIN(x1 + r, c->width - 1);
+					 x2++) {
+					if (los(c, y1, x1, y2, x2) !=
+						los_reference(c, y1, x1, y2, x2))
+						return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+int test_random_terrain(void *state) {
+	struct chunk *c = cave_new(z_info->dungeon_hgt, z_info->dungeon_wid);
+	int density, y, x;
+
+	Rand_state_init(1);
+	for (density = 10; density <= 70; density += 30) {
+		for (y = 0; y < c->height; y++)
+			for (x = 0; x < c->width; x++)
+				square_set_feat(c, y, x, randint0(100) < density ?
+								FEAT_GRANITE : FEAT_FLOOR);
+		require(los_matches(c, 3));
+	}
+
+	/* Changing terrain is seen straight away */
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++)
+			square_set_feat(c, y, x, FEAT_FLOOR);
+	eq(los(c, 10, 10, 10, 20), true);
+	eq(los(c, 10, 10, 17, 22), true);
+	square_set_feat(c, 10, 15, FEAT_GRANITE);
+	eq(los(c, 10, 10, 10, 20), false);
+	eq(los(c, 10, 10, 10, 20), los_reference(c, 10, 10, 10, 20));
+	square_set_feat(c, 10, 15, FEAT_OPEN);
+	eq(los(c, 10, 10, 10, 20), true);
+
+	cave_free(c);
+	ok;
+}
+
+int test_generated_levels(void *state) {
+	int depth;
+
+	for (depth = 1; depth < 100; depth += 14) {
+		player->depth = depth;
+		cave_generate(&cave, player);
+		notnull(cave);
+		require(los_matches(cave, 4));
+	}
+
+	ok;
+}
+
+const char *suite_name = "cave/los";
+struct test tests[] = {
+	{ "random-terrain", test_random_terrain },
+	{ "generated-levels", test_generated_levels },
+	{ NULL, NULL }
+};
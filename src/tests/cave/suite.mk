@@ -0,0 +1 @@
+TESTPROGS += cave/los
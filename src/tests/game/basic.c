@@ -9,6 +9,7 @@
 #include "cmd-core.h"
 #include "game-event.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "savefile.h"
 #include "player.h"
@@ -40,6 +41,7 @@ int setup_tests(void **state) {
 
 int teardown_tests(void **state) {
 	file_delete("Test1");
+	file_delete("Test2");
 	cleanup_angband();
 	return 0;
 }
@@ -92,6 +94,60 @@ int test_loadgame(void *state) {
 	ok;
 }
 
+int test_storetown(void *state) {
+	struct chunk *c;
+	byte *raw, *again;
+	u32b len, terrain_len;
+
+	/* The new game stored the town */
+	eq(chunk_list_max, 1);
+	eq(chunk_find_name("Town"), true);
+
+	/* Its stored encoding rebuilds a chunk which encodes the same way */
+	raw = chunk_list_encoding(chunk_list);
+	c = savefile_decode_chunk(raw, chunk_list->raw_len);
+	notnull(c);
+	again = savefile_encode_chunk(c, &len, &terrain_len);
+	eq(len, chunk_list->raw_len);
+	eq(terrain_len, chunk_list->terrain_len);
+	require(!memcmp(raw, again, len));
+	mem_free(raw);
+	mem_free(again);
+	cave_free(c);
+
+	/* It can be copied out of the list, and other chunks can't */
+	c = cave_new(z_info->town_hgt, z_info->town_wid);
+	eq(chunk_restore(c, "Town", 0, 0, 0, false), true);
+	eq(chunk_restore(c, "Nowhere", 0, 0, 0, false), false);
+	cave_free(c);
+
+	ok;
+}
+
+int test_resave(void *state) {
+	/* Loading replaces the town rather than adding another */
+	eq(savefile_load("Test1", false), true);
+	eq(chunk_list_max, 1);
+	eq(chunk_find_name("Town"), true);
+	eq(savefile_save("Test2"), true);
+	eq(savefile_load("Test2", false), true);
+	eq(chunk_list_max, 1);
+
+	ok;
+}
+
+int test_bgsave(void *state) {
+	/* A background save is on disk once it has been waited for */
+	eq(savefile_load("Test1", false), true);
+	eq(savefile_save_background("Test2"), true);
+	eq(savefile_wait(), true);
+	eq(file_exists("Test2"), true);
+	eq(savefile_load("Test2", false), true);
+	eq(player->is_dead, false);
+
+	ok;
+}
+
 int test_stairs1(void *state) {
 
 	/* Load the saved game */
@@ -176,7 +232,10 @@ int test_drop_eat(void *state) {
 const char *suite_name = "game/basic";
 struct test tests[] = {
 	{ "newgame", test_newgame },
+	{ "storetown", test_storetown },
 	{ "loadgame", test_loadgame },
+	{ "resave", test_resave },
+	{ "bgsave", test_bgsave },
 	{ "stairs1", test_stairs1 },
 	{ "stairs2", test_stairs2 },
 	{ "droppickup", test_drop_pickup },
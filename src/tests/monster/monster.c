@@ -43,8 +43,36 @@ int test_match_monster_bases(void *state) {
 	ok;
 }
 
+int test_lookup_monster(void *state) {
+	int i;
+
+	/* Every race can be found by its name, in any case */
+	for (i = 0; i < z_info->r_max; i++) {
+		struct monster_race *race = &r_info[i];
+		char upper[256];
+		size_t j;
+
+		if (!race->name) continue;
+		my_strcpy(upper, race->name, sizeof(upper));
+		for (j = 0; upper[j]; j++)
+			upper[j] = toupper((unsigned char) upper[j]);
+
+		/* Earlier races of the same name win */
+		require(my_stricmp(lookup_monster(race->name)->name, race->name) == 0);
+		require(lookup_monster(upper)->ridx <= race->ridx);
+	}
+
+	/* Partial names find the first race containing them */
+	ptreq(lookup_monster("Lord of Darkness"),
+	   lookup_monster("Morgoth, Lord of Darkness"));
+	null(lookup_monster("no such monster anywhere"));
+
+	ok;
+}
+
 const char *suite_name = "monster/monster";
 struct test tests[] = {
 	{ "match_monster_bases", test_match_monster_bases },
+	{ "lookup_monster", test_lookup_monster },
 	{ NULL, NULL }
 };
@@ -90,8 +90,35 @@ int test_obj_piles(void *state) {
 	ok;
 }
 
+/* Freed objects are handed out again, wiped, and counted */
+int test_obj_pool(void *state) {
+	struct object_pool_stats before, after;
+	struct object *o1, *o2;
+
+	object_pool_get_stats(&before);
+	o1 = object_new();
+	o1->number = 5;
+	object_pool_get_stats(&after);
+	eq(after.in_use, before.in_use + 1);
+	eq(after.allocs, before.allocs + 1);
+	require(after.capacity >= after.in_use);
+	require(after.peak >= after.in_use);
+
+	object_free(o1);
+	o2 = object_new();
+	ptreq(o2, o1);
+	eq(o2->number, 0);
+	null(o2->next);
+
+	object_free(o2);
+	object_pool_get_stats(&after);
+	eq(after.in_use, before.in_use);
+	ok;
+}
+
 const char *suite_name = "object/pile";
 struct test tests[] = {
 	{ "pile checking", test_obj_piles },
+	{ "object pool", test_obj_pool },
 	{ NULL, NULL }
 };
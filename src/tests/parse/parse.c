@@ -286,6 +286,42 @@ int test_rand1(void *state) {
 	ok;
 }
 
+static enum parser_error helper_rand2(struct parser *p) {
+	struct random v = parser_getrand(p, "r0");
+	int *wasok = parser_priv(p);
+	*wasok = v.base * 1000 + v.dice * 100 + v.sides * 10 + v.m_bonus;
+	return PARSE_ERROR_NONE;
+}
+
+int test_rand2(void *state) {
+	int wasok = 0;
+	errr r = parser_reg(state, "test-rand2 rand r0", helper_rand2);
+	eq(r, 0);
+	parser_setpriv(state, &wasok);
+	r = parser_parse(state, "test-rand2:5+2d3M4");
+	eq(r, 0);
+	eq(wasok, 5234);
+	r = parser_parse(state, "test-rand2:5+M4");
+	eq(r, 0);
+	eq(wasok, 5004);
+	r = parser_parse(state, "test-rand2:d3M4");
+	eq(r, 0);
+	eq(wasok, 134);
+	r = parser_parse(state, "test-rand2:7");
+	eq(r, 0);
+	eq(wasok, 7000);
+	r = parser_parse(state, "test-rand2:-2+1d4M3");
+	eq(r, 0);
+	eq(wasok, -10000 + 143);
+	r = parser_parse(state, "test-rand2:5M4");
+	eq(r, PARSE_ERROR_NOT_RANDOM);
+	r = parser_parse(state, "test-rand2:5+");
+	eq(r, PARSE_ERROR_NOT_RANDOM);
+	r = parser_parse(state, "test-rand2:2d3x");
+	eq(r, PARSE_ERROR_NOT_RANDOM);
+	ok;
+}
+
 static enum parser_error helper_opt0(struct parser *p) {
 	const char *s0 = parser_getsym(p, "s0");
 	const char *s1 = parser_hasval(p, "s1") ? parser_getsym(p, "s1") : NULL;
@@ -426,6 +462,7 @@ struct test tests[] = {
 
 	{ "rand0", test_rand0 },
 	{ "rand1", test_rand1 },
+	{ "rand2", test_rand2 },
 
 	{ "opt0", test_opt0 },
 
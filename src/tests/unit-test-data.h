@@ -1137,7 +1137,11 @@ static struct chunk TEST_DATA test_cave = {
 	.feeling_squares = 0,
 	.feat_count = NULL,
 
-	.squares = NULL,
+	.feat = NULL,
+	.info = NULL,
+	.mon = NULL,
+	.obj = NULL,
+	.trap = NULL,
 
 	.monsters = NULL,
 	.mon_max = 1,
@@ -0,0 +1,108 @@
+/* z-file/file.c */
+
+#include "unit-test.h"
+#include "z-file.h"
+#include "z-virt.h"
+
+static const char *test_file = "z-file-test.tmp";
+
+#define LONG_LINE 40000
+
+static const char *lines[] = {
+	"one", "two", "three", "four", "five    x", "", NULL, "last"
+};
+
+int setup_tests(void **state) {
+	ang_file *f = file_open(test_file, MODE_WRITE, FTYPE_TEXT);
+	char *buf = mem_zalloc(LONG_LINE + 1);
+
+	if (!f) return 1;
+	memset(buf, 'z', LONG_LINE);
+	file_write(f, "one\ntwo\r\nthree\rfour\r\r\nfive\tx\n\n", 30);
+	file_write(f, buf, LONG_LINE);
+	file_write(f, "\nlast", 5);
+	file_close(f);
+	mem_free(buf);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	file_delete(test_file);
+	return 0;
+}
+
+static bool check_line(const char *line, int i) {
+	size_t j;
+
+	if (lines[i]) return !strcmp(line, lines[i]);
+	if (strlen(line) != LONG_LINE) return false;
+	for (j = 0; j < LONG_LINE; j++)
+		if (line[j] != 'z') return false;
+	return true;
+}
+
+int test_nextl(void *state) {
+	ang_file *f = file_open(test_file, MODE_READ, FTYPE_TEXT);
+	const char *line;
+	size_t len;
+	int i;
+
+	require(f);
+	for (i = 0; i < (int) N_ELEMENTS(lines); i++) {
+		line = file_nextl(f, &len);
+		require(line);
+		require(check_line(line, i));
+		eq(len, strlen(line));
+	}
+	null(file_nextl(f, NULL));
+	file_close(f);
+	ok;
+}
+
+int test_getl(void *state) {
+	ang_file *f = file_open(test_file, MODE_READ, FTYPE_TEXT);
+	char *buf = mem_zalloc(LONG_LINE + 2);
+	int i;
+
+	require(f);
+	for (i = 0; i < (int) N_ELEMENTS(lines); i++) {
+		require(file_getl(f, buf, LONG_LINE + 2));
+		require(check_line(buf, i));
+	}
+	require(!file_getl(f, buf, LONG_LINE + 2));
+	file_close(f);
+	mem_free(buf);
+	ok;
+}
+
+int test_bytes(void *state) {
+	ang_file *f = file_open(test_file, MODE_READ, FTYPE_TEXT);
+	char buf[8];
+	byte b;
+
+	require(f);
+	require(file_readc(f, &b));
+	eq(b, 'o');
+	require(file_skip(f, 3));
+	eq(file_read(f, buf, 3), 3);
+	require(!strncmp(buf, "two", 3));
+	require(file_skip(f, -2));
+	require(file_readc(f, &b));
+	eq(b, 'w');
+
+	/* Skip past the buffered data and read on */
+	require(file_skip(f, 30 + LONG_LINE - 6));
+	eq(file_read(f, buf, 8), 5);
+	require(!strncmp(buf, "\nlast", 5));
+	require(!file_readc(f, &b));
+	file_close(f);
+	ok;
+}
+
+const char *suite_name = "z-file/file";
+struct test tests[] = {
+	{ "nextl", test_nextl },
+	{ "getl", test_getl },
+	{ "bytes", test_bytes },
+	{ NULL, NULL }
+};
@@ -0,0 +1,94 @@
+/* z-lookup/lookup.c */
+
+#include "unit-test.h"
+#include "z-form.h"
+#include "z-lookup.h"
+#include "z-virt.h"
+
+NOSETUP
+NOTEARDOWN
+
+int test_exact(void *state) {
+	struct name_index *index = name_index_new(false);
+
+	name_index_add(index, 0, "Ringil", 0);
+	name_index_add(index, 0, "Narya", 1);
+	name_index_add(index, 1, "Narya", 2);
+
+	eq(name_index_find(index, 0, "Ringil"), 0);
+	eq(name_index_find(index, 0, "Narya"), 1);
+	eq(name_index_find(index, 1, "Narya"), 2);
+
+	/* Case, group and the whole name all have to match */
+	eq(name_index_find(index, 0, "ringil"), -1);
+	eq(name_index_find(index, 1, "Ringil"), -1);
+	eq(name_index_find(index, 0, "Ring"), -1);
+	name_index_free(index);
+	ok;
+}
+
+int test_fold(void *state) {
+	struct name_index *index = name_index_new(true);
+
+	name_index_add(index, 5, "Potion of Speed", 3);
+	eq(name_index_find(index, 5, "potion of speed"), 3);
+	eq(name_index_find(index, 5, "POTION OF SPEED"), 3);
+	eq(name_index_find(index, 4, "potion of speed"), -1);
+	name_index_free(index);
+	ok;
+}
+
+int test_duplicates(void *state) {
+	struct name_index *index = name_index_new(false);
+	char name[16];
+	int i;
+
+	/* Enough names to make the table grow, with the same name between */
+	for (i = 0; i < 500; i++) {
+		strnfmt(name, sizeof(name), "name %d", i);
+		name_index_add(index, 0, i % 100 ? name : "of Resistance", i);
+	}
+
+	/* Records with the same name come back in order */
+	eq(name_index_find(index, 0, "of Resistance"), 0);
+	eq(name_index_find_after(index, 0, "of Resistance", 0), 100);
+	eq(name_index_find_after(index, 0, "of Resistance", 100), 200);
+	eq(name_index_find_after(index, 0, "of Resistance", 400), -1);
+	eq(name_index_find(index, 0, "name 499"), 499);
+	name_index_free(index);
+	ok;
+}
+
+int test_part(void *state) {
+	struct name_index *index = name_index_new(false);
+
+	name_index_add(index, 0, "Grip, Farmer Maggot's Dog", 1);
+	name_index_add(index, 0, "Fang, Farmer Maggot's Dog", 2);
+	name_index_add(index, 0, "Cave spider", 3);
+
+	/* The first record containing the text is found, ignoring case */
+	eq(name_index_find_part(index, "maggot"), 1);
+	eq(name_index_find_part(index, "FANG"), 2);
+	eq(name_index_find_part(index, "spider"), 3);
+	eq(name_index_find_part(index, "ve"), 3);
+	eq(name_index_find_part(index, "dragon"), -1);
+
+	/* Every run of three in the text being there is not enough */
+	name_index_add(index, 0, "abc-bcd", 4);
+	eq(name_index_find_part(index, "abcd"), -1);
+
+	/* Records added after a search are found too */
+	name_index_add(index, 0, "Smeagol", 5);
+	eq(name_index_find_part(index, "smea"), 5);
+	name_index_free(index);
+	ok;
+}
+
+const char *suite_name = "z-lookup/lookup";
+struct test tests[] = {
+	{ "exact", test_exact },
+	{ "fold", test_fold },
+	{ "duplicates", test_duplicates },
+	{ "part", test_part },
+	{ NULL, NULL }
+};
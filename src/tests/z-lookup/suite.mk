@@ -0,0 +1 @@
+TESTPROGS += z-lookup/lookup
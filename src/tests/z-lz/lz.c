@@ -0,0 +1,99 @@
+/* z-lz/lz.c */
+
+#include "unit-test.h"
+#include "z-lz.h"
+#include "z-rand.h"
+#include "z-virt.h"
+
+#define DATA_SIZE 20000
+
+NOSETUP
+NOTEARDOWN
+
+/* Compress then decompress, checking the data comes back the same */
+static bool round_trip(const byte *data, size_t len, size_t *packed_len)
+{
+	/* Room for the data as literals, with their length */
+	size_t max = len + len / 255 + 16;
+	byte *packed = mem_alloc(max);
+	byte *unpacked = mem_alloc(len + 1);
+	bool same;
+
+	*packed_len = lz_compress(data, len, packed, max);
+	same = *packed_len && lz_decompress(packed, *packed_len, unpacked, len) &&
+		!memcmp(data, unpacked, len);
+	mem_free(packed);
+	mem_free(unpacked);
+	return same;
+}
+
+int test_repetitive(void *state) {
+	byte *data = mem_alloc(DATA_SIZE);
+	size_t i, n;
+
+	/* Runs of bytes and repeated phrases, like a dungeon level */
+	for (i = 0; i < DATA_SIZE; i++)
+		data[i] = (i % 1000 < 600) ? 0 : "granite wall"[i % 12];
+	require(round_trip(data, DATA_SIZE, &n));
+	require(n < DATA_SIZE / 10);
+	mem_free(data);
+	ok;
+}
+
+int test_random(void *state) {
+	byte *data = mem_alloc(DATA_SIZE);
+	byte packed[DATA_SIZE / 2];
+	size_t i, n;
+
+	Rand_state_init(1);
+	for (i = 0; i < DATA_SIZE; i++)
+		data[i] = randint0(256);
+	require(round_trip(data, DATA_SIZE, &n));
+
+	/* Incompressible data does not fit in much less than it started as */
+	require(!lz_compress(data, DATA_SIZE, packed, sizeof(packed)));
+	mem_free(data);
+	ok;
+}
+
+int test_short(void *state) {
+	const byte data[] = "aaaaaaaaab";
+	size_t len;
+
+	for (len = 0; len < sizeof(data); len++) {
+		size_t n;
+		require(round_trip(data, len, &n));
+	}
+	ok;
+}
+
+int test_corrupt(void *state) {
+	byte data[256], packed[320], unpacked[256];
+	size_t i, n;
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = i % 7;
+	n = lz_compress(data, sizeof(data), packed, sizeof(packed));
+	require(n > 0);
+	require(lz_decompress(packed, n, unpacked, sizeof(data)));
+
+	/* Wrong lengths are caught */
+	require(!lz_decompress(packed, n - 1, unpacked, sizeof(data)));
+	require(!lz_decompress(packed, n, unpacked, sizeof(data) - 1));
+
+	/* So is a copy from before the start */
+	packed[0] = 0x00;
+	packed[1] = 0x01;
+	packed[2] = 0x00;
+	require(!lz_decompress(packed, 3, unpacked, sizeof(data)));
+	ok;
+}
+
+const char *suite_name = "z-lz/lz";
+struct test tests[] = {
+	{ "repetitive", test_repetitive },
+	{ "random", test_random },
+	{ "short", test_short },
+	{ "corrupt", test_corrupt },
+	{ NULL, NULL }
+};
@@ -0,0 +1 @@
+TESTPROGS += z-lz/lz
@@ -2,6 +2,8 @@
 
 #include "unit-test.h"
 #include "z-quark.h"
+#include "z-form.h"
+#include "z-virt.h"
 
 int setup_tests(void **state) {
 	quarks_init();
@@ -46,9 +48,57 @@ int test_dedup(void *state) {
 	ok;
 }
 
+int test_many(void *state) {
+	char buf[32];
+	const char *first;
+	quark_t q0, q;
+	int i;
+
+	/* New quarks are numbered in order */
+	q0 = quark_add("2-0");
+	first = quark_str(q0);
+	for (i = 1; i < 50000; i++) {
+		strnfmt(buf, sizeof(buf), "2-%d", i);
+		require(quark_add(buf) == q0 + i);
+	}
+
+	/* Every one can still be found, and its string has not moved */
+	for (i = 0; i < 50000; i++) {
+		strnfmt(buf, sizeof(buf), "2-%d", i);
+		q = quark_add(buf);
+		require(q == q0 + i);
+		require(!strcmp(quark_str(q), buf));
+	}
+	require(quark_str(q0) == first);
+
+	/* Earlier quarks are unaffected */
+	require(quark_add("0-foo") < q0);
+	require(!strcmp(quark_str(quark_add("1-bar")), "1-bar"));
+
+	ok;
+}
+
+int test_long(void *state) {
+	char *buf = mem_zalloc(10000);
+	quark_t q1, q2;
+
+	memset(buf, 'x', 9999);
+	q1 = quark_add(buf);
+	q2 = quark_add("3-short");
+
+	require(!strcmp(quark_str(q1), buf));
+	require(!strcmp(quark_str(q2), "3-short"));
+	require(quark_add(buf) == q1);
+
+	mem_free(buf);
+	ok;
+}
+
 const char *suite_name = "z-quark/quark";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "dedup", test_dedup },
+	{ "many", test_many },
+	{ "long", test_long },
 	{ NULL, NULL }
 };
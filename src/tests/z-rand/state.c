@@ -0,0 +1,58 @@
+/* z-rand/state.c */
+
+#include "unit-test.h"
+#include "z-rand.h"
+
+#define SEQ_LEN 64
+
+NOSETUP
+NOTEARDOWN
+
+static void draw(u32b *seq)
+{
+	int i;
+
+	for (i = 0; i < SEQ_LEN; i++)
+		seq[i] = Rand_div(0x10000000);
+}
+
+/* A seed gives the same numbers however much the RNG was used before */
+int test_reseed(void *state)
+{
+	u32b first[SEQ_LEN], again[SEQ_LEN];
+	int i;
+
+	Rand_quick = false;
+	Rand_state_init(1234);
+	draw(first);
+
+	/* Leave the state part way through the table */
+	for (i = 0; i < 13; i++)
+		Rand_div(100);
+
+	Rand_state_init(1234);
+	draw(again);
+	require(!memcmp(first, again, sizeof(first)));
+	ok;
+}
+
+/* Different seeds give different numbers */
+int test_seeds_differ(void *state)
+{
+	u32b one[SEQ_LEN], two[SEQ_LEN];
+
+	Rand_quick = false;
+	Rand_state_init(1);
+	draw(one);
+	Rand_state_init(2);
+	draw(two);
+	require(memcmp(one, two, sizeof(one)));
+	ok;
+}
+
+const char *suite_name = "z-rand/state";
+struct test tests[] = {
+	{ "reseed", test_reseed },
+	{ "seeds_differ", test_seeds_differ },
+	{ NULL, NULL }
+};
@@ -135,7 +135,7 @@ static bool square_verify_trap(struct chunk *c, int y, int x, int vis)
     /* No traps in this location. */
     if (!trap_exists) {
 		/* No traps */
-		sqinfo_off(c->squares[y][x].info, SQUARE_TRAP);
+		sqinfo_off(c->info[y][x], SQUARE_TRAP);
 
 		/* Take note */
 		square_note_spot(c, y, x);
@@ -254,7 +254,7 @@ void place_trap(struct chunk *c, int y, int x, int t_idx, int trap_level)
 		/* Require the correct terrain */
 		if (!square_player_trap_allowed(c, y, x)) return;
 
-		t_idx = pick_trap(c, c->squares[y][x].feat, trap_level);
+		t_idx = pick_trap(c, c->feat[y][x], trap_level);
     }
 
     /* Failure */
@@ -263,7 +263,7 @@ void place_trap(struct chunk *c, int y, int x, int t_idx, int trap_level)
 	/* Allocate a new trap for this grid (at the front of the list) */
 	new_trap = mem_zalloc(sizeof(*new_trap));
 	new_trap->next = square_trap(c, y, x);
-	c->squares[y][x].trap = new_trap;
+	c->trap[y][x] = new_trap;
 
 	/* Set the details */
 	new_trap->t_idx = t_idx;
@@ -274,7 +274,7 @@ void place_trap(struct chunk *c, int y, int x, int t_idx, int trap_level)
 	trf_copy(new_trap->flags, trap_info[t_idx].flags);
 
 	/* Toggle on the trap marker */
-	sqinfo_on(c->squares[y][x].info, SQUARE_TRAP);
+	sqinfo_on(c->info[y][x], SQUARE_TRAP);
 
 	/* Redraw the grid */
 	square_light_spot(c, y, x);
@@ -503,7 +503,7 @@ bool square_remove_all_traps(struct chunk *c, int y, int x)
 {
 	assert(square_in_bounds(c, y, x));
 
-	struct trap *trap = c->squares[y][x].trap;
+	struct trap *trap = c->trap[y][x];
 	bool were_there_traps = trap == NULL ? false : true;
 
 	while (trap) {
@@ -512,7 +512,7 @@ bool square_remove_all_traps(struct chunk *c, int y, int x)
 		trap = next_trap;
 	}
 
-	c->squares[y][x].trap = NULL;
+	c->trap[y][x] = NULL;
 
 	/* Refresh grids that the character can see */
 	if (square_isseen(c, y, x)) {
@@ -540,7 +540,7 @@ bool square_remove_trap(struct chunk *c, int y, int x, int t_idx_remove)
 
 	/* Look at the traps in this grid */
 	struct trap *prev_trap = NULL;
-	struct trap *trap = c->squares[y][x].trap;
+	struct trap *trap = c->trap[y][x];
 	while (trap) {
 		struct trap *next_trap = trap->next;
 
@@ -551,7 +551,7 @@ bool square_remove_trap(struct chunk *c, int y, int x, int t_idx_remove)
 			if (prev_trap) {
 				prev_trap->next = next_trap;
 			} else {
-				c->squares[y][x].trap = next_trap;
+				c->trap[y][x] = next_trap;
 			}
 
 			break;
@@ -588,7 +588,7 @@ bool square_set_trap_timeout(struct chunk *c, int y, int x, bool domsg,
 	assert(square_in_bounds(c, y, x));
 
 	/* Look at the traps in this grid */
-	current_trap = c->squares[y][x].trap;
+	current_trap = c->trap[y][x];
 	while (current_trap) {
 		/* Get the next trap (may be NULL) */
 		struct trap *next_trap = current_trap->next;
@@ -627,7 +627,7 @@ bool square_set_trap_timeout(struct chunk *c, int y, int x, bool domsg,
  */
 int square_trap_timeout(struct chunk *c, int y, int x, int t_idx)
 {
-	struct trap *current_trap = c->squares[y][x].trap;
+	struct trap *current_trap = c->trap[y][x];
 	while (current_trap) {
 		/* Get the next trap (may be NULL) */
 		struct trap *next_trap = current_trap->next;
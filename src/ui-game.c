@@ -470,11 +470,13 @@ void savefile_set_name(const char *fname, bool make_safe, bool strip_suffix)
 }
 
 /**
- * Save the game
+ * Save the game, leaving the savefile to be written in the background if
+ * `background` is set
  */
-void save_game(void)
+static void save_game_aux(bool background)
 {
 	char path[1024];
+	bool saved;
 
 	/* Disturb the player */
 	disturb(player, 1);
@@ -498,7 +500,11 @@ void save_game(void)
 	signals_ignore_tstp();
 
 	/* Save the player */
-	if (savefile_save(savefile))
+	if (background)
+		saved = savefile_save_background(savefile);
+	else
+		saved = savefile_save(savefile);
+	if (saved)
 		prt("Saving game... done.", 0, 0);
 	else
 		prt("Saving game... failed!", 0, 0);
@@ -530,6 +536,22 @@ void save_game(void)
 	my_strcpy(player->died_from, "(alive and well)", sizeof(player->died_from));
 }
 
+/**
+ * Save the game
+ */
+void save_game(void)
+{
+	save_game_aux(false);
+}
+
+/**
+ * Save the game without waiting for the savefile to reach the disk
+ */
+void autosave_game(void)
+{
+	save_game_aux(true);
+}
+
 
 
 /**
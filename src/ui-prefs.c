@@ -77,7 +77,7 @@ static void remove_old_dump(const char *cur_fname, const char *mark)
 	bool changed = false;
 	bool skip_one = false;
 
-	char buf[1024];
+	const char *buf;
 
 	char start_line[1024];
 	char end_line[1024];
@@ -109,7 +109,7 @@ static void remove_old_dump(const char *cur_fname, const char *mark)
 	}
 
 	/* Loop for every line */
-	while (file_getl(cur_file, buf, sizeof(buf))) {
+	while ((buf = file_nextl(cur_file, NULL))) {
 		/* Turn on at the start line, turn off at the finish line */
 		if (!strcmp(buf, start_line))
 			between_marks = true;
@@ -1130,11 +1130,11 @@ static bool process_pref_file_named(const char *path, bool quiet, bool user) {
 
 		e = PARSE_ERROR_INTERNAL; /* signal failure to callers */
 	} else {
-		char line[1024];
+		const char *line;
 		int line_no = 0;
 
 		struct parser *p = init_parse_prefs(user);
-		while (file_getl(f, line, sizeof line)) {
+		while ((line = file_nextl(f, NULL))) {
 			line_no++;
 
 			e = parser_parse(p, line);
@@ -248,8 +248,8 @@ static ui_event target_recall_loop_object(struct object *obj, int y, int x,
 			if (player->wizard) {
 				strnfmt(out_val, TARGET_OUT_VAL_SIZE,
 						"%s%s%s%s, %s (%d:%d, noise=%d, scent=%d).", s1, s2, s3,
-						o_name, coords, y, x, (int)cave->noise.grids[y][x],
-						(int)cave->scent.grids[y][x]);
+						o_name, coords, y, x, cave_noise(cave, y, x),
+						cave_scent(cave, y, x));
 			} else {
 				strnfmt(out_val, TARGET_OUT_VAL_SIZE,
 						"%s%s%s%s, %s.", s1, s2, s3, o_name, coords);
@@ -337,7 +337,7 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 		}
 
 		/* The player */
-		if (cave->squares[y][x].mon < 0) {
+		if (cave->mon[y][x] < 0) {
 			/* Description */
 			s1 = "You are ";
 
@@ -353,8 +353,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 			if (player->wizard)
 				strnfmt(out_val, sizeof(out_val),
 						"%s%s%s%s, %s (%d:%d, noise=%d, scent=%d).", s1, s2, s3,
-						name_strange, coords, y, x, (int)cave->noise.grids[y][x],
-						(int)cave->scent.grids[y][x]);
+						name_strange, coords, y, x, cave_noise(cave, y, x),
+						cave_scent(cave, y, x));
 			else
 				strnfmt(out_val, sizeof(out_val), "%s%s%s%s, %s.",
 						s1, s2, s3, name_strange, coords);
@@ -373,7 +373,7 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 		}
 
 		/* Actual monsters */
-		if (cave->squares[y][x].mon > 0) {
+		if (cave->mon[y][x] > 0) {
 			struct monster *mon = square_monster(cave, y, x);
 			const struct monster_lore *lore = get_lore(mon->race);
 
@@ -409,15 +409,15 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 
 						/* Describe the monster */
 						look_mon_desc(buf, sizeof(buf),
-									  cave->squares[y][x].mon);
+									  cave->mon[y][x]);
 
 						/* Describe, and prompt for recall */
 						if (player->wizard) {
 							strnfmt(out_val, sizeof(out_val),
 									"%s%s%s%s (%s), %s (%d:%d, noise=%d, scent=%d).",
 									s1, s2, s3, m_name, buf, coords, y, x,
-									(int)cave->noise.grids[y][x],
-									(int)cave->scent.grids[y][x]);
+									cave_noise(cave, y, x),
+									cave_scent(cave, y, x));
 						} else {
 							strnfmt(out_val, sizeof(out_val),
 									"%s%s%s%s (%s), %s.",
@@ -482,8 +482,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 						strnfmt(out_val, sizeof(out_val),
 								"%s%s%s%s, %s (%d:%d, noise=%d, scent=%d).",
 								s1, s2, s3, o_name, coords, y, x,
-								(int)cave->noise.grids[y][x],
-								(int)cave->scent.grids[y][x]);
+								cave_noise(cave, y, x),
+								cave_scent(cave, y, x));
 					}
 
 					prt(out_val, 0, 0);
@@ -523,7 +523,7 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 
 		/* A trap */
 		if (square_isvisibletrap(cave, y, x)) {
-			struct trap *trap = cave->squares[y][x].trap;
+			struct trap *trap = cave->trap[y][x];
 
 			/* Not boring */
 			boring = false;
@@ -531,7 +531,7 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 			/* Interact */
 			while (1) {
 				/* Change the intro */
-				if (cave->squares[y][x].mon < 0) {
+				if (cave->mon[y][x] < 0) {
 					s1 = "You are ";
 					s2 = "on ";
 				} else {
@@ -547,8 +547,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 					strnfmt(out_val, sizeof(out_val),
 							"%s%s%s%s, %s (%d:%d, noise=%d, scent=%d).", s1, s2,
 							s3, trap->kind->name, coords, y, x,
-							(int)cave->noise.grids[y][x],
-							(int)cave->scent.grids[y][x]);
+							cave_noise(cave, y, x),
+							cave_scent(cave, y, x));
 				} else {
 					strnfmt(out_val, sizeof(out_val), "%s%s%s%s, %s.", 
 							s1, s2, s3, trap->kind->desc, coords);
@@ -595,8 +595,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 						strnfmt(out_val, sizeof(out_val),
 								"%s%s%sa pile of %d objects, %s (%d:%d, noise=%d, scent=%d).",
 								s1, s2, s3, floor_num, coords, y, x,
-								(int)cave->noise.grids[y][x],
-								(int)cave->scent.grids[y][x]);
+								cave_noise(cave, y, x),
+								cave_scent(cave, y, x));
 					} else {
 						strnfmt(out_val, sizeof(out_val),
 								"%s%s%sa pile of %d objects, %s.",
@@ -698,8 +698,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 			if (player->wizard) {
 				strnfmt(out_val, sizeof(out_val),
 						"%s%s%s%s, %s (%d:%d, noise=%d, scent=%d).", s1, s2, s3,
-						name, coords, y, x, (int)cave->noise.grids[y][x],
-						(int)cave->scent.grids[y][x]);
+						name, coords, y, x, cave_noise(cave, y, x),
+						cave_scent(cave, y, x));
 			} else {
 				strnfmt(out_val, sizeof(out_val),
 						"%s%s%s%s, %s.", s1, s2, s3, name, coords);
@@ -151,7 +151,7 @@ static void do_cmd_wiz_hack_nick(void)
 				if (!square_in_bounds_fully(cave, y, x)) continue;
 
 				/* Display proper noise */
-				if (cave->noise.grids[y][x] != i) continue;
+				if (cave_noise(cave, y, x) != i) continue;
 
 				/* Display player/floors/walls */
 				if ((y == py) && (x == px))
@@ -180,7 +180,7 @@ static void do_cmd_wiz_hack_nick(void)
 				if (!square_in_bounds_fully(cave, y, x)) continue;
 
 				/* Display proper smell */
-				if (cave->scent.grids[y][x] != i) continue;
+				if (cave_scent(cave, y, x) != i) continue;
 
 				/* Display player/floors/walls */
 				if ((y == py) && (x == px))
@@ -945,9 +945,11 @@ static void wiz_reroll_item(struct object *obj)
 	if (obj->artifact) return;
 
 	/* Get new copy, hack off slays and brands */
-	new = mem_zalloc(sizeof(*new));
+	new = object_new();
 	object_copy(new, obj);
+	mem_free(new->slays);
 	new->slays = NULL;
+	mem_free(new->brands);
 	new->brands = NULL;
 
 	/* Main loop. Ask for magification and artifactification */
@@ -1017,8 +1019,8 @@ static void wiz_reroll_item(struct object *obj)
 		player->upkeep->redraw |= (PR_INVEN | PR_EQUIP );
 	}
 
-	/* Free the copy */
-	mem_free(new);
+	/* Free the copy, whose slays, brands and curses are its own */
+	object_free(new);
 }
 
 
@@ -1654,7 +1656,7 @@ static void do_cmd_wiz_query(void)
 			if (!square_in_bounds_fully(cave, y, x)) continue;
 
 			/* Given flag, show only those grids */
-			if (flag && !sqinfo_has(cave->squares[y][x].info, flag)) continue;
+			if (flag && !sqinfo_has(cave->info[y][x], flag)) continue;
 
 			/* Given no flag, show known grids */
 			if (!flag && (!square_isknown(cave, y, x))) continue;
@@ -1764,7 +1766,7 @@ static void do_cmd_wiz_features(void)
 
 			/* Given feature, show only those grids */
 			for (i = 0; i < length; i++)
-				if (cave->squares[y][x].feat == feat[i]) show = true;
+				if (cave->feat[y][x] == feat[i]) show = true;
 
 			/* Color */
 			if (square_ispassable(cave, y, x)) a = COLOUR_YELLOW;
@@ -1834,6 +1836,36 @@ static void wiz_test_kind(int tval)
 	msg("Done.");
 }
 
+#ifdef MEM_PROFILE
+static void wiz_memory_line(void *data, const char *text)
+{
+	file_put(data, text);
+}
+#endif
+
+/**
+ * Write the allocation profile to 'memory.log' in the user directory.
+ */
+static void do_cmd_wiz_memory(void)
+{
+#ifdef MEM_PROFILE
+	char buf[1024];
+	ang_file *fh;
+
+	path_build(buf, sizeof(buf), ANGBAND_DIR_USER, "memory.log");
+	fh = file_open(buf, MODE_WRITE, FTYPE_TEXT);
+	if (!fh) {
+		msg("Cannot create memory.log.");
+		return;
+	}
+	mem_profile_report(wiz_memory_line, fh);
+	file_close(fh);
+	msg("Allocation profile written to memory.log.");
+#else
+	msg("Allocation profiling needs a build with MEM_PROFILE defined.");
+#endif
+}
+
 /**
  * Display the debug commands help file.
  */
@@ -2118,6 +2150,13 @@ void get_debug_command(void)
 			break;
 		}
 
+		/* Allocation profile */
+		case 'M':
+		{
+			do_cmd_wiz_memory();
+			break;
+		}
+
 		/* Magic Mapping */
 		case 'm':
 		{
@@ -46,6 +46,15 @@
 # include <sys/types.h>
 #endif
 
+/**
+ * Privileges belong to the whole process, so when savefiles can be written
+ * on a second thread, changes to them are serialised by a lock
+ */
+#if defined(SETGID) && defined(HAVE_PTHREAD_H)
+# define SETUID_LOCK
+# include <pthread.h>
+#endif
+
 #if defined (WINDOWS) && !defined (CYGWIN)
 # define my_mkdir(path, perms) mkdir(path)
 #elif defined(HAVE_MKDIR) || defined(MACH_O_CARBON) || defined (CYGWIN)
@@ -60,11 +69,16 @@
 int player_uid;
 int player_egid;
 
+#ifdef SETUID_LOCK
+static pthread_mutex_t setuid_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool setuid_held = false;
+#endif
+
 
 
 
 /**
- * Drop permissions
+ * Drop permissions, and let other threads grab them again
  */
 void safe_setuid_drop(void)
 {
@@ -81,14 +95,26 @@ void safe_setuid_drop(void)
 
 # endif
 #endif /* SETGID */
+
+#ifdef SETUID_LOCK
+	if (setuid_held) {
+		setuid_held = false;
+		pthread_mutex_unlock(&setuid_lock);
+	}
+#endif
 }
 
 
 /**
- * Grab permissions
+ * Grab permissions, waiting until no other thread has them
  */
 void safe_setuid_grab(void)
 {
+#ifdef SETUID_LOCK
+	pthread_mutex_lock(&setuid_lock);
+	setuid_held = true;
+#endif
+
 #ifdef SETGID
 # if defined(HAVE_SETRESGID)
 
@@ -263,8 +289,20 @@ struct ang_file
 	FILE *fh;
 	char *fname;
 	file_mode mode;
+
+	/* Read buffer for MODE_READ; the unread data is buf[pos] to buf[end] */
+	char *buf;
+	size_t size;
+	size_t pos;
+	size_t end;
+
+	/* Space for lines whose tabs file_nextl() has expanded */
+	char *line;
+	size_t line_size;
 };
 
+#define FILE_BUFFER_SIZE 16384
+
 
 
 /** Utility functions **/
@@ -431,6 +469,8 @@ bool file_close(ang_file *f)
 	if (fclose(f->fh) != 0)
 		return false;
 
+	mem_free(f->line);
+	mem_free(f->buf);
 	mem_free(f->fname);
 	mem_free(f);
 
@@ -476,11 +516,52 @@ void file_unlock(ang_file *f)
 
 /** Byte-based IO and functions **/
 
+/**
+ * Read more of file 'f' into its read buffer, after any data not yet used,
+ * which is moved to the start of the buffer.  The buffer grows if it is
+ * full, and always keeps a spare byte after the data.
+ *
+ * Returns false if nothing more could be read.
+ */
+static bool file_fill(ang_file *f)
+{
+	size_t got;
+
+	if (f->pos) {
+		memmove(f->buf, f->buf + f->pos, f->end - f->pos);
+		f->end -= f->pos;
+		f->pos = 0;
+	}
+
+	if (f->end + 1 >= f->size) {
+		f->size = f->size ? f->size * 2 : FILE_BUFFER_SIZE;
+		f->buf = mem_realloc(f->buf, f->size);
+	}
+
+	got = fread(f->buf + f->end, 1, f->size - f->end - 1, f->fh);
+	f->end += got;
+
+	return got > 0;
+}
+
 /**
  * Seek to location 'pos' in file 'f'.
  */
 bool file_skip(ang_file *f, int bytes)
 {
+	if (f->mode == MODE_READ) {
+		/* Stay within the buffer if possible */
+		if ((bytes >= 0 && (size_t) bytes <= f->end - f->pos) ||
+			(bytes < 0 && (size_t) -bytes <= f->pos)) {
+			f->pos += bytes;
+			return true;
+		}
+
+		/* The file itself is positioned at the end of the buffered data */
+		bytes -= (int) (f->end - f->pos);
+		f->pos = f->end = 0;
+	}
+
 	return (fseek(f->fh, bytes, SEEK_CUR) == 0);
 }
 
@@ -489,8 +570,17 @@ bool file_skip(ang_file *f, int bytes)
  */
 bool file_readc(ang_file *f, byte *b)
 {
-	int i = fgetc(f->fh);
+	int i;
+
+	if (f->mode == MODE_READ) {
+		if (f->pos == f->end && !file_fill(f))
+			return false;
 
+		*b = (byte) f->buf[f->pos++];
+		return true;
+	}
+
+	i = fgetc(f->fh);
 	if (i == EOF)
 		return false;
 
@@ -511,7 +601,16 @@ bool file_writec(ang_file *f, byte b)
  */
 int file_read(ang_file *f, char *buf, size_t n)
 {
-	size_t read = fread(buf, 1, n, f->fh);
+	size_t read = 0;
+
+	/* Use up any buffered data first */
+	if (f->mode == MODE_READ) {
+		read = MIN(n, f->end - f->pos);
+		memcpy(buf, f->buf + f->pos, read);
+		f->pos += read;
+	}
+
+	read += fread(buf + read, 1, n - read, f->fh);
 
 	if (read == 0 && ferror(f->fh))
 		return -1;
@@ -527,6 +626,22 @@ bool file_write(ang_file *f, const char *buf, size_t n)
 	return fwrite(buf, 1, n, f->fh) == n;
 }
 
+/**
+ * Flush file 'f' and, where the platform allows, push it out to disk.
+ */
+bool file_sync(ang_file *f)
+{
+	if (fflush(f->fh) != 0)
+		return false;
+
+#if defined(HAVE_FSYNC) && !defined(WINDOWS)
+	if (fsync(fileno(f->fh)) != 0)
+		return false;
+#endif
+
+	return true;
+}
+
 /** Line-based IO **/
 
 /**
@@ -562,7 +677,7 @@ bool file_getl(ang_file *f, char *buf, size_t len)
 		}
 
 		if (seen_cr && c != '\n') {
-			fseek(f->fh, -1, SEEK_CUR);
+			file_skip(f, -1);
 			buf[i] = '\0';
 			return true;
 		}
@@ -592,6 +707,83 @@ bool file_getl(ang_file *f, char *buf, size_t len)
 	return true;
 }
 
+/**
+ * Read the next line of text from file 'f', which must be open for reading,
+ * and return it without copying, or NULL at the end of the file.
+ *
+ * Line endings are treated as by file_getl(), but lines are not limited in
+ * length.  Tabs are expanded only if the line has any.  If 'len' is not NULL
+ * it is set to the length of the line.  The line is overwritten by the next
+ * read from 'f'.
+ */
+const char *file_nextl(ang_file *f, size_t *len)
+{
+	size_t n = 0, skip;
+	char *line;
+
+	assert(f->mode == MODE_READ);
+
+	/* Find the end of the line, reading more of the file as needed */
+	while (true) {
+		while (f->pos + n < f->end && f->buf[f->pos + n] != '\n' &&
+			   f->buf[f->pos + n] != '\r')
+			n++;
+		if (f->pos + n < f->end || !file_fill(f))
+			break;
+	}
+
+	/* End of file */
+	if (f->pos == f->end)
+		return NULL;
+
+	/* Skip any carriage returns, then a newline */
+	skip = n;
+	if (f->pos + skip < f->end && f->buf[f->pos + skip] == '\r') {
+		while (true) {
+			while (f->pos + skip < f->end && f->buf[f->pos + skip] == '\r')
+				skip++;
+			if (f->pos + skip < f->end || !file_fill(f))
+				break;
+		}
+	}
+	if (f->pos + skip < f->end && f->buf[f->pos + skip] == '\n')
+		skip++;
+
+	/* Terminate the line where its ending was */
+	line = f->buf + f->pos;
+	line[n] = '\0';
+	f->pos += skip;
+
+	/* Expand tabs */
+	if (memchr(line, '\t', n)) {
+		size_t i, j = 0;
+
+		for (i = 0; i < n; i++) {
+			size_t need = (line[i] == '\t') ?
+				((j + TAB_COLUMNS) / TAB_COLUMNS) * TAB_COLUMNS : j + 1;
+
+			if (need + 1 > f->line_size) {
+				f->line_size = MAX(2 * f->line_size, need + 1);
+				f->line = mem_realloc(f->line, f->line_size);
+			}
+
+			if (line[i] == '\t') {
+				while (j < need)
+					f->line[j++] = ' ';
+			} else {
+				f->line[j++] = line[i];
+			}
+		}
+
+		f->line[j] = '\0';
+		line = f->line;
+		n = j;
+	}
+
+	if (len) *len = n;
+	return line;
+}
+
 /**
  * Append a line of text 'buf' to the end of file 'f', using system-dependent
  * line ending.
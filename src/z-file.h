@@ -45,6 +45,10 @@ extern int player_egid;
  * safe_setuid_drop() should be called immediately after the file has been
  * opened, to prevent security risks, and restores the game's rights so that it
  * cannot write to the system-wide files.
+ *
+ * Privileges are shared by every thread, so where a savefile may be written on
+ * a second thread, a thread that has grabbed them holds them until it drops
+ * them, and any other thread grabbing them meanwhile waits.
  */
 void safe_setuid_grab(void);
 void safe_setuid_drop(void);
@@ -191,6 +195,18 @@ void file_unlock(ang_file *f);
  */
 bool file_getl(ang_file *f, char *buf, size_t n);
 
+/**
+ * Get the next line of text from the file represented by `f`, which must be
+ * open for reading, without copying it.
+ *
+ * Line endings and tabs are dealt with as by file_getl(), but the line may be
+ * of any length.  If `len` is not NULL the length of the line is put there.
+ *
+ * Returns the line, which is only valid until the next read from `f`, or NULL
+ * at the end of the file.
+ */
+const char *file_nextl(ang_file *f, size_t *len);
+
 /**
  * Write the string pointed to by `buf` to the file represented by `f`.
  *
@@ -227,6 +243,13 @@ int file_read(ang_file *f, char *buf, size_t n);
  */
 bool file_write(ang_file *f, const char *buf, size_t n);
 
+/**
+ * Flush the file represented by `f` and ask the system to write it to disk.
+ *
+ * Returns true if successful, false otherwise.
+ */
+bool file_sync(ang_file *f);
+
 /**
  * Read a byte from the file represented by `f` and place it at the location
  * specified by 'b'.
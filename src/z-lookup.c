@@ -0,0 +1,314 @@
+/**
+ * \file z-lookup.c
+ * \brief Hashed lookup of records by name, with a substring index
+ *
+ * Copyright (c) 2017 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+#include "z-lookup.h"
+#include "z-util.h"
+#include "z-virt.h"
+
+/**
+ * Names are kept in an open-addressed hash table whose slots hold entry
+ * numbers plus one, with 0 marking an empty slot.  The table is kept at
+ * most half full.  Entries with the same name sit along the same probe
+ * sequence in the order they were added, so the first one found is the
+ * first one added.
+ *
+ * Substring searches use a second table, built when first wanted, from each
+ * three-character run of a (case-folded) name to the entries containing it
+ * in the order they were added.  A search only checks the entries on the
+ * shortest list among the runs in what it is looking for.
+ */
+struct name_entry {
+	int group;
+	int idx;
+	char *name;
+};
+
+struct name_gram {
+	u32b gram;
+	int *entries;
+	int n;
+	int size;
+};
+
+struct name_index {
+	bool fold_case;
+
+	struct name_entry *entries;
+	int n;
+	int size;
+
+	int *slots;
+	size_t slots_size;
+
+	struct name_gram *grams;
+	size_t grams_size;
+	size_t grams_n;
+};
+
+#define NAME_INDEX_INIT	64
+
+static int name_char(const struct name_index *index, char c)
+{
+	return index->fold_case ? toupper((unsigned char) c) : (unsigned char) c;
+}
+
+/**
+ * djb2, as djb2_hash(), of the group and the name as the index compares it
+ */
+static u32b name_hash(const struct name_index *index, int group,
+					  const char *name)
+{
+	u32b hash = 5381 + (u32b) group;
+
+	for (; *name; name++)
+		hash = ((hash << 5) + hash) + name_char(index, *name);
+
+	return hash;
+}
+
+static bool name_match(const struct name_index *index,
+					   const struct name_entry *entry, int group,
+					   const char *name)
+{
+	const char *s = entry->name;
+
+	if (entry->group != group) return false;
+	if (!index->fold_case) return streq(s, name);
+
+	for (; *s && *name; s++, name++)
+		if (name_char(index, *s) != name_char(index, *name))
+			return false;
+
+	return !*s && !*name;
+}
+
+static void name_index_insert(struct name_index *index, int entry)
+{
+	size_t mask = index->slots_size - 1;
+	const struct name_entry *e = &index->entries[entry];
+	size_t slot = name_hash(index, e->group, e->name) & mask;
+
+	while (index->slots[slot])
+		slot = (slot + 1) & mask;
+	index->slots[slot] = entry + 1;
+}
+
+struct name_index *name_index_new(bool fold_case)
+{
+	struct name_index *index = mem_zalloc(sizeof(*index));
+
+	index->fold_case = fold_case;
+	index->size = NAME_INDEX_INIT;
+	index->entries = mem_zalloc(index->size * sizeof(struct name_entry));
+	index->slots_size = 2 * NAME_INDEX_INIT;
+	index->slots = mem_zalloc(index->slots_size * sizeof(int));
+
+	return index;
+}
+
+static void name_index_free_grams(struct name_index *index)
+{
+	size_t i;
+
+	for (i = 0; i < index->grams_size; i++)
+		mem_free(index->grams[i].entries);
+	mem_free(index->grams);
+	index->grams = NULL;
+	index->grams_size = 0;
+	index->grams_n = 0;
+}
+
+void name_index_free(struct name_index *index)
+{
+	int i;
+
+	if (!index) return;
+
+	for (i = 0; i < index->n; i++)
+		string_free(index->entries[i].name);
+	mem_free(index->entries);
+	mem_free(index->slots);
+	name_index_free_grams(index);
+	mem_free(index);
+}
+
+void name_index_add(struct name_index *index, int group, const char *name,
+					int idx)
+{
+	struct name_entry *entry;
+
+	/* Grow the table, keeping it at most half full */
+	if ((size_t) (index->n + 1) * 2 > index->slots_size) {
+		int i;
+
+		mem_free(index->slots);
+		index->slots_size *= 2;
+		index->slots = mem_zalloc(index->slots_size * sizeof(int));
+		for (i = 0; i < index->n; i++)
+			name_index_insert(index, i);
+	}
+
+	if (index->n == index->size) {
+		index->size *= 2;
+		index->entries = mem_realloc(index->entries,
+									 index->size * sizeof(struct name_entry));
+	}
+
+	entry = &index->entries[index->n];
+	entry->group = group;
+	entry->idx = idx;
+	entry->name = string_make(name);
+	name_index_insert(index, index->n++);
+
+	/* Any substring index is out of date */
+	name_index_free_grams(index);
+}
+
+int name_index_find_after(const struct name_index *index, int group,
+						  const char *name, int after)
+{
+	size_t mask = index->slots_size - 1;
+	size_t slot = name_hash(index, group, name) & mask;
+
+	for (; index->slots[slot]; slot = (slot + 1) & mask) {
+		const struct name_entry *entry = &index->entries[index->slots[slot] - 1];
+
+		if (entry->idx > after && name_match(index, entry, group, name))
+			return entry->idx;
+	}
+
+	return -1;
+}
+
+int name_index_find(const struct name_index *index, int group,
+					const char *name)
+{
+	return name_index_find_after(index, group, name, -1);
+}
+
+/**
+ * The three characters at `s`, case-folded, packed into one number; none of
+ * them is 0, so neither is the result
+ */
+static u32b name_gram(const char *s)
+{
+	return ((u32b) toupper((unsigned char) s[0]) << 16) |
+		((u32b) toupper((unsigned char) s[1]) << 8) |
+		(u32b) toupper((unsigned char) s[2]);
+}
+
+static struct name_gram *name_gram_slot(struct name_gram *grams, size_t size,
+										u32b gram)
+{
+	size_t mask = size - 1;
+	size_t slot = (gram * 2654435761U) & mask;
+
+	while (grams[slot].gram && grams[slot].gram != gram)
+		slot = (slot + 1) & mask;
+
+	return &grams[slot];
+}
+
+/**
+ * Build the substring index, noting each entry under every run of three
+ * characters in its name
+ */
+static void name_index_build_grams(struct name_index *index)
+{
+	int i;
+
+	index->grams_size = 2 * NAME_INDEX_INIT;
+	index->grams = mem_zalloc(index->grams_size * sizeof(struct name_gram));
+
+	for (i = 0; i < index->n; i++) {
+		const char *s;
+
+		for (s = index->entries[i].name; s[0] && s[1] && s[2]; s++) {
+			u32b gram = name_gram(s);
+			struct name_gram *g = name_gram_slot(index->grams,
+												 index->grams_size, gram);
+
+			/* A name can have the same run twice */
+			if (g->gram && g->entries[g->n - 1] == i) continue;
+
+			if (!g->gram) {
+				g->gram = gram;
+				g->size = 4;
+				g->entries = mem_alloc(g->size * sizeof(int));
+				index->grams_n++;
+			} else if (g->n == g->size) {
+				g->size *= 2;
+				g->entries = mem_realloc(g->entries, g->size * sizeof(int));
+			}
+			g->entries[g->n++] = i;
+
+			/* Grow the table, keeping it at most half full */
+			if (index->grams_n * 2 > index->grams_size) {
+				struct name_gram *old = index->grams;
+				size_t j, old_size = index->grams_size;
+
+				index->grams_size *= 2;
+				index->grams = mem_zalloc(index->grams_size *
+										  sizeof(struct name_gram));
+				for (j = 0; j < old_size; j++)
+					if (old[j].gram)
+						*name_gram_slot(index->grams, index->grams_size,
+										old[j].gram) = old[j];
+				mem_free(old);
+			}
+		}
+	}
+}
+
+int name_index_find_part(struct name_index *index, const char *part)
+{
+	const struct name_gram *best = NULL;
+	const char *s;
+	int i;
+
+	/* Too short to have a run of three, so check everything */
+	if (strlen(part) < 3) {
+		for (i = 0; i < index->n; i++)
+			if (my_stristr(index->entries[i].name, part))
+				return index->entries[i].idx;
+		return -1;
+	}
+
+	if (!index->grams)
+		name_index_build_grams(index);
+
+	/* Find the run of three in `part` that fewest names contain */
+	for (s = part; s[2]; s++) {
+		const struct name_gram *g = name_gram_slot(index->grams,
+												   index->grams_size,
+												   name_gram(s));
+
+		if (!g->gram) return -1;
+		if (!best || g->n < best->n)
+			best = g;
+	}
+
+	/* Check those names in order */
+	for (i = 0; i < best->n; i++) {
+		const struct name_entry *entry = &index->entries[best->entries[i]];
+
+		if (my_stristr(entry->name, part))
+			return entry->idx;
+	}
+
+	return -1;
+}
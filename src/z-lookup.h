@@ -0,0 +1,71 @@
+/**
+ * \file z-lookup.h
+ * \brief Hashed lookup of records by name, with a substring index
+ *
+ * Copyright (c) 2017 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_Z_LOOKUP_H
+#define INCLUDED_Z_LOOKUP_H
+
+#include "h-basic.h"
+
+/**
+ * An index from names to the array indexes of the records that bear them.
+ *
+ * Each name is filed under a group number, such as a tval, and both must
+ * match for a record to be found.  Records must be added in order of their
+ * array index; where several have the same name, the first added is found
+ * first.
+ */
+struct name_index;
+
+/**
+ * Make an empty index, which matches names ignoring case if `fold_case` is
+ * set and exactly otherwise
+ */
+struct name_index *name_index_new(bool fold_case);
+
+/**
+ * Free an index
+ */
+void name_index_free(struct name_index *index);
+
+/**
+ * Add the record at array index `idx`, with name `name` in group `group`
+ */
+void name_index_add(struct name_index *index, int group, const char *name,
+					int idx);
+
+/**
+ * Return the array index of the first record with the given group and name,
+ * or -1 if there is none
+ */
+int name_index_find(const struct name_index *index, int group,
+					const char *name);
+
+/**
+ * Return the array index of the first record after array index `after` with
+ * the given group and name, or -1 if there is none
+ */
+int name_index_find_after(const struct name_index *index, int group,
+						  const char *name, int after);
+
+/**
+ * Return the array index of the first record, in any group, whose name
+ * contains `part` ignoring case, or -1 if there is none
+ */
+int name_index_find_part(struct name_index *index, const char *part);
+
+#endif /* !INCLUDED_Z_LOOKUP_H */
@@ -0,0 +1,195 @@
+/**
+ * \file z-lz.c
+ * \brief Small LZ77 compressor for savefile blocks
+ *
+ * Copyright (c) 2017 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+#include "z-lz.h"
+
+/**
+ * The compressed data is a series of sequences, each a run of literal bytes
+ * followed by a copy of earlier output:
+ *
+ *   token         high nibble: literal count, low nibble: copy length - 4;
+ *                 a nibble of 15 is followed by more length bytes
+ *   [lengths]     bytes added to a literal count of 15, until one isn't 255
+ *   literals
+ *   offset        two bytes, little endian, how far back the copy starts
+ *   [lengths]     bytes added to a copy length nibble of 15, as above
+ *
+ * The last sequence stops after its literals, which is known because the
+ * decompressed length is known.  Copies may overlap what they produce, so a
+ * run of one byte is a single literal followed by a copy from offset 1.
+ */
+
+#define LZ_MIN_MATCH	4
+#define LZ_MAX_OFFSET	65535
+#define LZ_HASH_BITS	12
+
+static u32b lz_read32(const byte *p)
+{
+	return (u32b) p[0] | ((u32b) p[1] << 8) | ((u32b) p[2] << 16) |
+		((u32b) p[3] << 24);
+}
+
+static u32b lz_hash(u32b v)
+{
+	return (v * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+/**
+ * Write a length beyond what fits in a token nibble
+ */
+static bool lz_put_length(byte *dst, size_t *op, size_t max, size_t n)
+{
+	while (n >= 255) {
+		if (*op >= max) return false;
+		dst[(*op)++] = 255;
+		n -= 255;
+	}
+	if (*op >= max) return false;
+	dst[(*op)++] = (byte) n;
+	return true;
+}
+
+/**
+ * Write one sequence; a copy length of 0 means there is no copy
+ */
+static bool lz_put_sequence(byte *dst, size_t *op, size_t max,
+							const byte *lit, size_t nlit, size_t offset,
+							size_t copy)
+{
+	size_t lit_code = MIN(nlit, 15);
+	size_t copy_code = copy ? MIN(copy - LZ_MIN_MATCH, 15) : 0;
+
+	if (*op >= max) return false;
+	dst[(*op)++] = (byte) ((lit_code << 4) | copy_code);
+	if (lit_code == 15 && !lz_put_length(dst, op, max, nlit - 15))
+		return false;
+
+	if (max - *op < nlit) return false;
+	memcpy(dst + *op, lit, nlit);
+	*op += nlit;
+	if (!copy) return true;
+
+	if (max - *op < 2) return false;
+	dst[(*op)++] = (byte) (offset & 0xFF);
+	dst[(*op)++] = (byte) (offset >> 8);
+	if (copy_code == 15 &&
+		!lz_put_length(dst, op, max, copy - LZ_MIN_MATCH - 15))
+		return false;
+	return true;
+}
+
+/**
+ * Compress `len` bytes from `src` into at most `max` bytes at `dst`.
+ *
+ * Returns the compressed length, or 0 if it would not fit.
+ */
+size_t lz_compress(const byte *src, size_t len, byte *dst, size_t max)
+{
+	u32b table[1 << LZ_HASH_BITS];
+	size_t ip = 0, anchor = 0, op = 0;
+
+	/* Positions are stored plus one, so 0 is an empty slot */
+	memset(table, 0, sizeof(table));
+
+	while (len >= LZ_MIN_MATCH && ip <= len - LZ_MIN_MATCH) {
+		u32b seq = lz_read32(src + ip);
+		u32b h = lz_hash(seq);
+		size_t ref = table[h];
+
+		table[h] = ip + 1;
+		if (ref-- && ip - ref <= LZ_MAX_OFFSET &&
+			lz_read32(src + ref) == seq) {
+			size_t copy = LZ_MIN_MATCH;
+
+			while (ip + copy < len && src[ref + copy] == src[ip + copy])
+				copy++;
+			if (!lz_put_sequence(dst, &op, max, src + anchor, ip - anchor,
+								 ip - ref, copy))
+				return 0;
+			ip += copy;
+			anchor = ip;
+		} else {
+			ip++;
+		}
+	}
+
+	/* The rest is literals */
+	if (!lz_put_sequence(dst, &op, max, src + anchor, len - anchor, 0, 0))
+		return 0;
+	return op;
+}
+
+/**
+ * Read a length beyond what fits in a token nibble
+ */
+static bool lz_get_length(const byte *src, size_t len, size_t *ip, size_t *n)
+{
+	byte b;
+
+	do {
+		if (*ip >= len) return false;
+		b = src[(*ip)++];
+		*n += b;
+	} while (b == 255);
+	return true;
+}
+
+/**
+ * Decompress `len` bytes from `src` into exactly `dst_len` bytes at `dst`.
+ *
+ * Returns false if the data is malformed or does not come to `dst_len`.
+ */
+bool lz_decompress(const byte *src, size_t len, byte *dst, size_t dst_len)
+{
+	size_t ip = 0, op = 0;
+
+	while (true) {
+		size_t nlit, copy, offset;
+		byte token;
+
+		if (ip >= len) return false;
+		token = src[ip++];
+
+		/* Literals */
+		nlit = token >> 4;
+		if (nlit == 15 && !lz_get_length(src, len, &ip, &nlit))
+			return false;
+		if (len - ip < nlit || dst_len - op < nlit) return false;
+		memcpy(dst + op, src + ip, nlit);
+		ip += nlit;
+		op += nlit;
+
+		/* The last sequence has no copy */
+		if (op == dst_len) return ip == len;
+
+		/* Copy */
+		if (len - ip < 2) return false;
+		offset = src[ip] | (src[ip + 1] << 8);
+		ip += 2;
+		copy = token & 0x0F;
+		if (copy == 15 && !lz_get_length(src, len, &ip, &copy))
+			return false;
+		copy += LZ_MIN_MATCH;
+		if (!offset || offset > op || dst_len - op < copy) return false;
+
+		/* Byte by byte, as the copy may overlap itself */
+		while (copy--) {
+			dst[op] = dst[op - offset];
+			op++;
+		}
+	}
+}
@@ -0,0 +1,27 @@
+/**
+ * \file z-lz.h
+ * \brief Small LZ77 compressor for savefile blocks
+ *
+ * Copyright (c) 2017 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_Z_LZ_H
+#define INCLUDED_Z_LZ_H
+
+#include "h-basic.h"
+
+size_t lz_compress(const byte *src, size_t len, byte *dst, size_t max);
+bool lz_decompress(const byte *src, size_t len, byte *dst, size_t dst_len);
+
+#endif /* INCLUDED_Z_LZ_H */
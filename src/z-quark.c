@@ -19,6 +19,7 @@
  */
 #include "z-virt.h"
 #include "z-quark.h"
+#include "z-util.h"
 #include "init.h"
 
 static char **quarks;
@@ -27,14 +28,92 @@ static size_t alloc_quarks = 0;
 
 #define QUARKS_INIT	16
 
+/**
+ * Open-addressed hash table of quarks, so finding an existing quark does
+ * not mean comparing against every other one.  Slots hold quark numbers,
+ * with 0 marking an empty slot; the table is kept at most half full.
+ */
+static quark_t *quark_table;
+static size_t quark_table_size = 0;
+
+#define QUARK_TABLE_INIT	64
+
+/**
+ * Quark strings are copied into large blocks rather than allocated one at
+ * a time.  Blocks never move, so the strings stay put until quarks_free().
+ */
+struct quark_block {
+	struct quark_block *next;
+	size_t used;
+	size_t size;
+	char text[];
+};
+
+static struct quark_block *quark_blocks;
+
+#define QUARK_BLOCK_SIZE	4096
+
+/**
+ * Copy a string into the current block, starting a new block if it is full
+ */
+static char *quark_store(const char *str)
+{
+	size_t len = strlen(str) + 1;
+	char *copy;
+
+	if (!quark_blocks || quark_blocks->size - quark_blocks->used < len) {
+		size_t size = MAX(len, QUARK_BLOCK_SIZE);
+		struct quark_block *block = mem_alloc(sizeof(*block) + size);
+
+		block->next = quark_blocks;
+		block->used = 0;
+		block->size = size;
+		quark_blocks = block;
+	}
+
+	copy = quark_blocks->text + quark_blocks->used;
+	memcpy(copy, str, len);
+	quark_blocks->used += len;
+
+	return copy;
+}
+
+/**
+ * Find the hash table slot for a string: the slot holding its quark if it
+ * has one, otherwise the empty slot where its quark should go
+ */
+static size_t quark_slot(const char *str)
+{
+	size_t mask = quark_table_size - 1;
+	size_t slot = djb2_hash(str) & mask;
+
+	while (quark_table[slot] && strcmp(quarks[quark_table[slot]], str))
+		slot = (slot + 1) & mask;
+
+	return slot;
+}
+
+/**
+ * Double the size of the hash table
+ */
+static void quark_table_grow(void)
+{
+	quark_t q;
+
+	mem_free(quark_table);
+	quark_table_size *= 2;
+	quark_table = mem_zalloc(quark_table_size * sizeof(quark_t));
+	for (q = 1; q < nr_quarks; q++)
+		quark_table[quark_slot(quarks[q])] = q;
+}
+
 quark_t quark_add(const char *str)
 {
 	quark_t q;
+	size_t slot = quark_slot(str);
 
-	for (q = 1; q < nr_quarks; q++) {
-		if (!strcmp(quarks[q], str))
-			return q;
-	}
+	if (quark_table[slot])
+		return quark_table[slot];
 
 	if (nr_quarks == alloc_quarks) {
 		alloc_quarks *= 2;
@@ -42,7 +121,12 @@ quark_t quark_add(const char *str)
 	}
 
 	q = nr_quarks++;
-	quarks[q] = string_make(str);
+	quarks[q] = quark_store(str);
+	quark_table[slot] = q;
+
+	/* Keep the table no more than half full */
+	if (nr_quarks * 2 > quark_table_size)
+		quark_table_grow();
 
 	return q;
 }
@@ -56,17 +140,26 @@ void quarks_init(void)
 {
 	alloc_quarks = QUARKS_INIT;
 	quarks = mem_zalloc(alloc_quarks * sizeof(char*));
+	quark_table_size = QUARK_TABLE_INIT;
+	quark_table = mem_zalloc(quark_table_size * sizeof(quark_t));
 }
 
 void quarks_free(void)
 {
-	size_t i;
+	while (quark_blocks) {
+		struct quark_block *next = quark_blocks->next;
+		mem_free(quark_blocks);
+		quark_blocks = next;
+	}
 
-	/* quarks[0] is special */
-	for (i = 1; i < nr_quarks; i++)
-		string_free(quarks[i]);
+	mem_free(quark_table);
+	quark_table = NULL;
+	quark_table_size = 0;
 
 	mem_free(quarks);
+	quarks = NULL;
+	nr_quarks = 1;
+	alloc_quarks = 0;
 }
 
 struct init_module z_quark_module = {
@@ -102,6 +102,9 @@ void Rand_state_init(u32b seed)
 {
 	int i, j;
 
+	/* Start from the same index every time, so a seed gives one sequence */
+	state_i = 0;
+
 	/* Seed the table */
 	STATE[0] = seed;
 
@@ -15,6 +15,7 @@
  *    and not for profit purposes provided that this copyright and statement
  *    are included in all such copies.  Other copyrights may also apply.
  */
+#define Z_VIRT_C
 #include "z-virt.h"
 #include "z-util.h"
 
@@ -22,6 +23,123 @@ unsigned int mem_flags = 0;
 
 #define SZ(uptr)	*((size_t *)((char *)(uptr) - sizeof(size_t)))
 
+#ifdef MEM_PROFILE
+
+/**
+ * Number of lifetime histogram buckets; bucket n counts blocks freed after
+ * between 2^(n-1) and 2^n - 1 further allocations had been made
+ */
+#define MEM_LIFETIME_BUCKETS 32
+
+/**
+ * Maximum number of call sites tracked, a power of two; any more are all
+ * counted against the last slot
+ */
+#define MEM_MAX_SITES 4096
+
+/**
+ * What is known about the allocations made from one place in the source
+ */
+struct mem_site {
+	const char *file;
+	int line;
+	unsigned long allocs;
+	unsigned long frees;
+	unsigned long long bytes;
+	size_t live;
+	size_t peak;
+	unsigned long lifetime[MEM_LIFETIME_BUCKETS];
+};
+
+/**
+ * Each block starts with its site and the allocation clock when it was made;
+ * the size stays last, so SZ() finds it as usual
+ */
+struct mem_header {
+	struct mem_site *site;
+	unsigned long birth;
+	size_t len;
+};
+
+#define MEM_HEADER	sizeof(struct mem_header)
+#define HDR(uptr)	((struct mem_header *)((char *)(uptr) - MEM_HEADER))
+
+static struct mem_site mem_sites[MEM_MAX_SITES];
+static int mem_site_count;
+static unsigned long mem_clock;
+static size_t mem_live, mem_peak;
+
+static void mem_profile_exit(void);
+
+/**
+ * Find the record for a call site, adding it if it is new.  Sites are told
+ * apart by the address of their __FILE__ string as well as the line, which
+ * is enough because each translation unit has its own copy.
+ */
+static struct mem_site *mem_site_find(const char *file, int line)
+{
+	size_t h = (((size_t) file >> 4) * 31 + line) & (MEM_MAX_SITES - 1);
+
+	while (mem_sites[h].file) {
+		if (mem_sites[h].file == file && mem_sites[h].line == line)
+			return &mem_sites[h];
+		h = (h + 1) & (MEM_MAX_SITES - 1);
+	}
+
+	/* Keep one slot free, so the search above always ends */
+	if (mem_site_count == MEM_MAX_SITES - 1)
+		return &mem_sites[(h + MEM_MAX_SITES - 1) & (MEM_MAX_SITES - 1)];
+
+	if (!mem_site_count++)
+		atexit(mem_profile_exit);
+	mem_sites[h].file = file;
+	mem_sites[h].line = line;
+	return &mem_sites[h];
+}
+
+/**
+ * Record a block being made
+ */
+static void mem_profile_birth(void *mem, size_t len, const char *file,
+							  int line)
+{
+	struct mem_site *site = mem_site_find(file, line);
+
+	HDR(mem)->site = site;
+	HDR(mem)->birth = mem_clock++;
+	site->allocs++;
+	site->bytes += len;
+	site->live += len;
+	if (site->live > site->peak) site->peak = site->live;
+	mem_live += len;
+	if (mem_live > mem_peak) mem_peak = mem_live;
+}
+
+/**
+ * Record a block going away
+ */
+static void mem_profile_death(void *mem)
+{
+	struct mem_site *site = HDR(mem)->site;
+	unsigned long age = mem_clock - HDR(mem)->birth;
+	int bucket = 0;
+
+	while (age && bucket < MEM_LIFETIME_BUCKETS - 1) {
+		age >>= 1;
+		bucket++;
+	}
+	site->frees++;
+	site->live -= SZ(mem);
+	site->lifetime[bucket]++;
+	mem_live -= SZ(mem);
+}
+
+#else /* MEM_PROFILE */
+
+#define MEM_HEADER	sizeof(size_t)
+
+#endif /* MEM_PROFILE */
+
 /**
  * Allocate `len` bytes of memory.
  *
@@ -31,61 +149,184 @@ unsigned int mem_flags = 0;
  *
  * Doesn't return on out of memory.
  */
+#ifdef MEM_PROFILE
+void *mem_alloc(size_t len)
+{
+	return mem_alloc_at(len, __FILE__, __LINE__);
+}
+
+void *mem_alloc_at(size_t len, const char *file, int line)
+#else
 void *mem_alloc(size_t len)
+#endif
 {
 	char *mem;
 
 	/* Allow allocation of "zero bytes" */
 	if (len == 0) return (NULL);
 
-	mem = malloc(len + sizeof(size_t));
+	mem = malloc(len + MEM_HEADER);
 	if (!mem)
 		quit("Out of Memory!");
-	mem += sizeof(size_t);
+	mem += MEM_HEADER;
 	if (mem_flags & MEM_POISON_ALLOC)
 		memset(mem, 0xCC, len);
 	SZ(mem) = len;
+#ifdef MEM_PROFILE
+	mem_profile_birth(mem, len, file, line);
+#endif
 
 	return mem;
 }
 
+#ifdef MEM_PROFILE
+void *mem_zalloc(size_t len)
+{
+	return mem_zalloc_at(len, __FILE__, __LINE__);
+}
+
+void *mem_zalloc_at(size_t len, const char *file, int line)
+{
+	void *mem = mem_alloc_at(len, file, line);
+	memset(mem, 0, len);
+	return mem;
+}
+#else
 void *mem_zalloc(size_t len)
 {
 	void *mem = mem_alloc(len);
 	memset(mem, 0, len);
 	return mem;
 }
+#endif
 
 void mem_free(void *p)
 {
 	if (!p) return;
 
+#ifdef MEM_PROFILE
+	mem_profile_death(p);
+#endif
 	if (mem_flags & MEM_POISON_FREE)
 		memset(p, 0xCD, SZ(p));
-	free((char *)p - sizeof(size_t));
+	free((char *)p - MEM_HEADER);
+}
+
+#ifdef MEM_PROFILE
+void *mem_realloc(void *p, size_t len)
+{
+	return mem_realloc_at(p, len, __FILE__, __LINE__);
 }
 
+/**
+ * A reallocated block counts as freed by its old site and made afresh by
+ * the new one
+ */
+void *mem_realloc_at(void *p, size_t len, const char *file, int line)
+#else
 void *mem_realloc(void *p, size_t len)
+#endif
 {
 	char *m = p;
 
 	/* Fail gracefully */
 	if (len == 0) return (NULL);
 
-	m = realloc(m ? m - sizeof(size_t) : NULL, len + sizeof(size_t));
-	m += sizeof(size_t);
+#ifdef MEM_PROFILE
+	if (m) mem_profile_death(m);
+#endif
+	m = realloc(m ? m - MEM_HEADER : NULL, len + MEM_HEADER);
 
 	/* Handle OOM */
 	if (!m) quit("Out of Memory!");
+	m += MEM_HEADER;
 	SZ(m) = len;
+#ifdef MEM_PROFILE
+	mem_profile_birth(m, len, file, line);
+#endif
 
 	return m;
 }
 
+#ifdef MEM_PROFILE
+
+/**
+ * Order sites by total bytes allocated, largest first
+ */
+static int mem_site_cmp(const void *a, const void *b)
+{
+	const struct mem_site *sa = *(const struct mem_site * const *) a;
+	const struct mem_site *sb = *(const struct mem_site * const *) b;
+
+	if (sa->bytes != sb->bytes) return sa->bytes < sb->bytes ? 1 : -1;
+	if (sa->allocs != sb->allocs) return sa->allocs < sb->allocs ? 1 : -1;
+	return 0;
+}
+
+/**
+ * Report on every call site that has allocated memory, a line at a time
+ * through `out`.  Lifetimes are measured in allocations made while the block
+ * was live, and the histogram gives the count for each power of two.
+ */
+void mem_profile_report(void (*out)(void *data, const char *text), void *data)
+{
+	struct mem_site *sorted[MEM_MAX_SITES];
+	char buf[1024];
+	int i, j, n = 0;
+
+	for (i = 0; i < MEM_MAX_SITES; i++)
+		if (mem_sites[i].file)
+			sorted[n++] = &mem_sites[i];
+	qsort(sorted, n, sizeof(sorted[0]), mem_site_cmp);
+
+	snprintf(buf, sizeof(buf), "%lu allocations, %lu bytes live, %lu peak\n",
+			mem_clock, (unsigned long) mem_live, (unsigned long) mem_peak);
+	out(data, buf);
+	out(data, "site allocs frees bytes live peak lifetimes(log2:count)\n");
+	for (i = 0; i < n; i++) {
+		struct mem_site *site = sorted[i];
+		size_t len;
+
+		snprintf(buf, sizeof(buf), "%s:%d %lu %lu %llu %lu %lu", site->file,
+				site->line, site->allocs, site->frees, site->bytes,
+				(unsigned long) site->live, (unsigned long) site->peak);
+		len = strlen(buf);
+		for (j = 0; j < MEM_LIFETIME_BUCKETS; j++) {
+			if (!site->lifetime[j]) continue;
+			snprintf(buf + len, sizeof(buf) - len, " %d:%lu", j,
+					site->lifetime[j]);
+			len = strlen(buf);
+		}
+		my_strcat(buf, "\n", sizeof(buf));
+		out(data, buf);
+	}
+}
+
+static void mem_profile_print(void *data, const char *text)
+{
+	fputs(text, data);
+}
+
+static void mem_profile_exit(void)
+{
+	mem_profile_report(mem_profile_print, stderr);
+}
+
+#endif /* MEM_PROFILE */
+
 /**
  * Duplicates an existing string `str`, allocating as much memory as necessary.
  */
+#ifdef MEM_PROFILE
+char *string_make(const char *str)
+{
+	return string_make_at(str, __FILE__, __LINE__);
+}
+
+char *string_make_at(const char *str, const char *file, int line)
+#else
 char *string_make(const char *str)
+#endif
 {
 	char *res;
 	size_t siz;
@@ -95,7 +336,11 @@ char *string_make(const char *str)
 
 	/* Allocate space for the string (including terminator) */
 	siz = strlen(str) + 1;
+#ifdef MEM_PROFILE
+	res = mem_alloc_at(siz, file, line);
+#else
 	res = mem_alloc(siz);
+#endif
 
 	/* Copy the string (with terminator) */
 	my_strcpy(res, str, siz);
@@ -34,4 +34,28 @@ enum {
 
 extern unsigned int mem_flags;
 
+/**
+ * Allocation profiling.  Building with MEM_PROFILE defined makes every
+ * allocation record where it was made, so that mem_profile_report() can list
+ * each call site with its allocation count, bytes, live and peak live bytes
+ * and a histogram of how long its blocks lived.  A report is written to
+ * stderr at exit.
+ */
+#ifdef MEM_PROFILE
+
+void *mem_alloc_at(size_t len, const char *file, int line);
+void *mem_zalloc_at(size_t len, const char *file, int line);
+void *mem_realloc_at(void *p, size_t len, const char *file, int line);
+char *string_make_at(const char *str, const char *file, int line);
+void mem_profile_report(void (*out)(void *data, const char *text), void *data);
+
+#ifndef Z_VIRT_C
+#define mem_alloc(len) mem_alloc_at((len), __FILE__, __LINE__)
+#define mem_zalloc(len) mem_zalloc_at((len), __FILE__, __LINE__)
+#define mem_realloc(p, len) mem_realloc_at((p), (len), __FILE__, __LINE__)
+#define string_make(str) string_make_at((str), __FILE__, __LINE__)
+#endif
+
+#endif /* MEM_PROFILE */
+
 #endif /* INCLUDED_Z_VIRT_H */